@@ -0,0 +1,61 @@
+/*
+ * Main authors:
+ *    Gonzalo Hernandez <gonzalo.hernandez@monash>
+ *    <gonzalo.hernandez@udenar.edu.co>
+ *
+ * Contributing authors:
+ *    Guido Tack <guido.tack@monash.edu>
+ *    Julian Gutierrez <J.Gutierrez@sussex.ac.uk>
+ *
+ * This file is part of NOCQ (a CP Toolchain for parity games with quantitative
+ * conditions).
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public License,
+ * v. 2.0. If a copy of the MPL was not distributed with this file, You can get
+ * one at https://mozilla.org/MPL/2.0/.
+ *
+ *-----------------------------------------------------------------------------
+ */
+#ifndef AMO_H
+#define AMO_H
+
+#include <vector>
+#include <cmath>
+
+//=============================================================================
+// Product encoding of "at most one of x" (Chen's 2-product): x[k] sits in
+// row k/q and column k%q of a p*q grid and implies both of them, and at most
+// one row and one column may be active. That is about 2*sqrt(n) auxiliary
+// literals and 2n clauses, against n-1 and 3n for the sequential counter.
+// Literals are opaque to the encoding:
+//
+//   L    newVar()                          a fresh literal
+//   void imply(a, b)                       clause -a \/ b
+//   void never(a, b)                       clause -a \/ -b
+
+template <typename L, typename NewVar, typename Imply, typename Never>
+void productAMO(const std::vector<L>& x, NewVar newVar, Imply imply,
+                Never never)
+{
+    size_t n = x.size();
+    if (n <= 4) {
+        for (size_t i=0; i<n; i++) {
+            for (size_t j=i+1; j<n; j++) never(x[i], x[j]);
+        }
+        return;
+    }
+
+    size_t p = std::ceil(std::sqrt(static_cast<double>(n)));
+    size_t q = (n + p - 1) / p;
+    std::vector<L> rows, cols;
+    for (size_t i=0; i<p; i++) rows.push_back(newVar());
+    for (size_t j=0; j<q; j++) cols.push_back(newVar());
+    for (size_t k=0; k<n; k++) {
+        imply(x[k], rows[k/q]);
+        imply(x[k], cols[k%q]);
+    }
+    productAMO(rows, newVar, imply, never);
+    productAMO(cols, newVar, imply, never);
+}
+
+#endif // AMO_H
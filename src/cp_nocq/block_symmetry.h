@@ -0,0 +1,284 @@
+/*
+ * Main authors:
+ *    Gonzalo Hernandez <gonzalo.hernandez@monash>
+ *    <gonzalo.hernandez@udenar.edu.co>
+ *
+ * Contributing authors:
+ *    Guido Tack <guido.tack@monash.edu>
+ *    Julian Gutierrez <J.Gutierrez@sussex.ac.uk>
+ *
+ * This file is part of NOCQ (a CP Toolchain for parity games with quantitative
+ * conditions).
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public License,
+ * v. 2.0. If a copy of the MPL was not distributed with this file, You can get
+ * one at https://mozilla.org/MPL/2.0/.
+ *
+ *-----------------------------------------------------------------------------
+ */
+#ifndef BLOCK_SYMMETRY_H
+#define BLOCK_SYMMETRY_H
+
+#ifndef GAME_H
+#include "../utils/game.h"
+#endif
+
+#include <vector>
+#include <map>
+#include <algorithm>
+
+//=============================================================================
+// Interchangeable blocks of a game, for symmetry breaking over one variable
+// per vertex. Two blocks are interchangeable when swapping them, and nothing
+// else, is an automorphism of the coloured graph (owners, priorities,
+// weights) that fixes init and keeps the meaning of every variable: a PLAYER
+// vertex names its out-edge by position, so it only moves to a vertex whose
+// out-edges correspond in order, and a vertex left in place only points into
+// the blocks when it is an OPPONENT's, whose edges are active together.
+//
+// Colour refinement gives the candidates. Each swap is then searched by
+// matching edges outwards and inwards from a pair of vertices of the same
+// colour, preferring to leave shared neighbours in place, and checked on
+// every edge it touches. Blocks swapped with the same first block, pairwise
+// disjoint, form a group of rows any two of which can be exchanged.
+
+class BlockSymmetry {
+public:
+    struct Group {
+        int32_t rows, cols;
+        std::vector<int32_t> vertices;  // row-major, columns aligned
+    };
+
+private:
+    Game& g;
+    parity_type player;
+    std::vector<int32_t> colour;
+
+    std::vector<int32_t> sigma;         // current swap, -1 where unmapped
+    std::vector<int32_t> touched;       // vertices with sigma set
+    std::vector<std::pair<int32_t,int32_t>> pairs;  // moved, first side first
+    std::vector<int32_t> used;          // per vertex: round of the last use
+    std::vector<char> inGroup;
+
+    //-------------------------------------------------------------------------
+    // Colour refinement: owner, priority and init first, then the out-edges
+    // (in order for PLAYER vertices) and in-edges with the colours at their
+    // other end. A bounded number of rounds; a coarser colouring only costs
+    // failed searches.
+
+    void refine() {
+        colour.assign(g.nvertices, 0);
+        std::map<std::vector<int64_t>,int32_t> ids;
+        for (int32_t v=0; v<g.nvertices; v++) {
+            std::vector<int64_t> key = {g.owners[v], g.priors[v], v == g.init};
+            colour[v] = ids.emplace(key, ids.size()).first->second;
+        }
+        size_t classes = ids.size();
+
+        for (int32_t round=0; round<32; round++) {
+            ids.clear();
+            std::vector<int32_t> next(g.nvertices);
+            for (int32_t v=0; v<g.nvertices; v++) {
+                std::vector<std::pair<int64_t,int64_t>> out, in;
+                for (size_t j=0; j<g.outs[v].size(); j++) {
+                    int32_t e = g.outs[v][j];
+                    out.push_back({g.weights[e], colour[g.targets[e]]});
+                }
+                for (size_t j=0; j<g.ins[v].size(); j++) {
+                    int32_t e = g.ins[v][j];
+                    in.push_back({g.weights[e], colour[g.sources[e]]});
+                }
+                if (g.owners[v] != player) std::sort(out.begin(), out.end());
+                std::sort(in.begin(), in.end());
+
+                std::vector<int64_t> key = {colour[v], -1};
+                for (auto& x : out) { key.push_back(x.first); key.push_back(x.second); }
+                key.push_back(-1);
+                for (auto& x : in)  { key.push_back(x.first); key.push_back(x.second); }
+                next[v] = ids.emplace(key, ids.size()).first->second;
+            }
+            colour = next;
+            if (ids.size() == classes) break;
+            classes = ids.size();
+        }
+    }
+
+    //-------------------------------------------------------------------------
+
+    int32_t image(int32_t v) const { return sigma[v] < 0 ? v : sigma[v]; }
+
+    // Maps x (first side) to y, or checks that it already is.
+    bool map(int32_t x, int32_t y, std::vector<std::pair<int32_t,int32_t>>& queue) {
+        if (sigma[x] >= 0 || sigma[y] >= 0) return sigma[x] == y;
+        if (colour[x] != colour[y]) return false;
+        sigma[x] = y;
+        touched.push_back(x);
+        if (x == y) return true;
+        sigma[y] = x;
+        touched.push_back(y);
+        pairs.push_back({x,y});
+        queue.push_back({x,y});
+        return true;
+    }
+
+    // Matches the edges of x to those of y (ordered for PLAYER vertices on
+    // out-edges), preferring endpoints already mapped, then left in place.
+    bool match(const vec<int32_t>& ex, const vec<int32_t>& ey, bool ordered,
+               const vec<int32_t>& ends,
+               std::vector<std::pair<int32_t,int32_t>>& queue)
+    {
+        if (ex.size() != ey.size()) return false;
+        if (ordered) {
+            for (size_t j=0; j<ex.size(); j++) {
+                if (g.weights[ex[j]] != g.weights[ey[j]]) return false;
+                if (!map(ends[ex[j]], ends[ey[j]], queue)) return false;
+            }
+            return true;
+        }
+        std::vector<char> taken(ey.size(), 0);
+        for (size_t j=0; j<ex.size(); j++) {
+            int32_t a = ends[ex[j]];
+            int32_t pick = -1;
+            for (int32_t pass=0; pass<3 && pick<0; pass++) {
+                for (size_t k=0; k<ey.size() && pick<0; k++) {
+                    int32_t b = ends[ey[k]];
+                    if (taken[k] || g.weights[ey[k]] != g.weights[ex[j]]) continue;
+                    if (colour[a] != colour[b]) continue;
+                    bool ok = pass == 0 ? sigma[a] == b
+                            : pass == 1 ? a == b && sigma[a] < 0
+                            : sigma[a] < 0 && sigma[b] < 0;
+                    if (ok) pick = k;
+                }
+            }
+            if (pick < 0) return false;
+            taken[pick] = 1;
+            if (!map(a, ends[ey[pick]], queue)) return false;
+        }
+        return true;
+    }
+
+    //-------------------------------------------------------------------------
+    // The edges of v against those of its image: in order for a PLAYER vertex,
+    // as a multiset otherwise.
+
+    bool consistent(int32_t v) const {
+        int32_t w = image(v);
+        if (g.outs[v].size() != g.outs[w].size()) return false;
+        std::vector<std::pair<int64_t,int32_t>> a, b;
+        for (size_t j=0; j<g.outs[v].size(); j++) {
+            int32_t e = g.outs[v][j], f = g.outs[w][j];
+            a.push_back({g.weights[e], image(g.targets[e])});
+            b.push_back({g.weights[f], g.targets[f]});
+        }
+        if (g.owners[v] != player) {
+            std::sort(a.begin(), a.end());
+            std::sort(b.begin(), b.end());
+        }
+        return a == b;
+    }
+
+    //-------------------------------------------------------------------------
+    // Searches the swap of x and y. On success 'pairs' lists the moved
+    // vertices, x's side first, in the order they were matched.
+
+    bool swap(int32_t x, int32_t y) {
+        for (int32_t v : touched) sigma[v] = -1;
+        touched.clear();
+        pairs.clear();
+
+        std::vector<std::pair<int32_t,int32_t>> queue;
+        if (!map(x, y, queue) || x == y) return false;
+        for (size_t q=0; q<queue.size(); q++) {
+            int32_t u = queue[q].first, w = queue[q].second;
+            if (!match(g.outs[u], g.outs[w], g.owners[u] == player,
+                       g.targets, queue)) return false;
+            if (!match(g.ins[u], g.ins[w], false, g.sources, queue)) {
+                return false;
+            }
+        }
+
+        for (auto& p : pairs) {
+            if (!consistent(p.first) || !consistent(p.second)) return false;
+            for (int32_t v : {p.first, p.second}) {
+                for (size_t j=0; j<g.ins[v].size(); j++) {
+                    int32_t u = g.sources[g.ins[v][j]];
+                    if (sigma[u] == u || sigma[u] < 0) {
+                        if (!consistent(u)) return false;
+                    }
+                }
+            }
+        }
+        return true;
+    }
+
+    //-------------------------------------------------------------------------
+
+    void search() {
+        std::vector<std::vector<int32_t>> classes;
+        std::map<int32_t,int32_t> index;
+        for (int32_t v=0; v<g.nvertices; v++) {
+            auto it = index.emplace(colour[v], classes.size()).first;
+            if (it->second == (int32_t)classes.size()) classes.emplace_back();
+            classes[it->second].push_back(v);
+        }
+
+        int32_t round = 0;
+        for (auto& c : classes) {
+            for (size_t i=0; i<c.size(); i++) {
+                int32_t pivot = c[i];
+                if (inGroup[pivot]) continue;
+
+                round++;
+                std::vector<int32_t> first;
+                std::vector<std::vector<int32_t>> rows;
+                for (size_t j=i+1; j<c.size(); j++) {
+                    if (inGroup[c[j]] || !swap(pivot, c[j])) continue;
+
+                    std::vector<int32_t> a, b;
+                    for (auto& p : pairs) {
+                        a.push_back(p.first);
+                        b.push_back(p.second);
+                    }
+                    if (rows.empty()) {
+                        bool free = true;
+                        for (int32_t v : a) free &= !inGroup[v];
+                        if (!free) break;
+                        first = a;
+                        for (int32_t v : a) used[v] = round;
+                    }
+                    else if (a != first) continue;
+
+                    bool free = true;
+                    for (int32_t v : b) free &= used[v] != round && !inGroup[v];
+                    if (!free) continue;
+                    for (int32_t v : b) used[v] = round;
+                    rows.push_back(b);
+                }
+                if (rows.empty()) continue;
+
+                Group group;
+                group.rows = rows.size()+1;
+                group.cols = first.size();
+                group.vertices = first;
+                for (auto& r : rows) {
+                    group.vertices.insert(group.vertices.end(), r.begin(), r.end());
+                }
+                for (int32_t v : group.vertices) inGroup[v] = 1;
+                groups.push_back(group);
+            }
+        }
+    }
+
+public:
+    std::vector<Group> groups;
+
+    BlockSymmetry(Game& g, parity_type player)
+    :   g(g), player(player), sigma(g.nvertices, -1),
+        used(g.nvertices, 0), inGroup(g.nvertices, 0)
+    {
+        refine();
+        search();
+    }
+};
+
+#endif // BLOCK_SYMMETRY_H
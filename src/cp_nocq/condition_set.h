@@ -0,0 +1,140 @@
+/*
+ * Main authors:
+ *    Gonzalo Hernandez <gonzalo.hernandez@monash>
+ *    <gonzalo.hernandez@udenar.edu.co>
+ *
+ * Contributing authors:
+ *    Guido Tack <guido.tack@monash.edu>
+ *    Julian Gutierrez <J.Gutierrez@sussex.ac.uk>
+ *
+ * This file is part of NOCQ (a CP Toolchain for parity games with quantitative
+ * conditions).
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public License,
+ * v. 2.0. If a copy of the MPL was not distributed with this file, You can get
+ * one at https://mozilla.org/MPL/2.0/.
+ *
+ *-----------------------------------------------------------------------------
+ */
+#ifndef CONDITION_SET_H
+#define CONDITION_SET_H
+
+#ifndef WINNING_CONDITIONS_H
+#include "winning_conditions.h"
+#endif
+
+#include <vector>
+
+//=============================================================================
+// The winning conditions a NOC propagator checks on every closed cycle. Each
+// combination of parity, energy and mean-payoff has its own evaluator,
+// Static<Kinds>, which visit() hands to the enumeration so the check is
+// inlined there. Any other set (a custom condition, or a kind given twice)
+// falls back to the virtual satisfy() of each condition.
+//
+// EVEN needs every condition on a cycle and ODD any of them, whose tests are
+// the negations of EVEN's, so a set holds for ODD exactly when it fails for
+// EVEN.
+
+class ConditionSet {
+public:
+    enum { PARITY = 1, ENERGY = 2, MEANPAYOFF = 4, DYNAMIC = -1 };
+
+private:
+    std::vector<WinningCondition*> conds;
+    parity_type playerSAT;
+    int32_t kinds = 0;
+    int64_t energy = 0;                 // energy threshold
+    int64_t p = 0;                      // mean-payoff threshold p/q
+    int64_t q = 1;
+
+public:
+    ConditionSet(vec<WinningCondition*>& winConditions, parity_type playerSAT)
+    :   playerSAT(playerSAT)
+    {
+        for (size_t i=0; i<winConditions.size(); i++) {
+            WinningCondition* c = winConditions[i];
+            conds.push_back(c);
+
+            int32_t kind = DYNAMIC;
+            if (dynamic_cast<ParityCondition*>(c)) {
+                kind = PARITY;
+            }
+            else if (auto en = dynamic_cast<EnergyCondition*>(c)) {
+                kind = ENERGY;
+                energy = en->getThreshold();
+            }
+            else if (auto mp = dynamic_cast<MeanPayoffCondition*>(c)) {
+                kind = MEANPAYOFF;
+                mp->getFraction(p,q);
+            }
+            if (kinds == DYNAMIC) continue;
+            kinds = (kind == DYNAMIC || (kinds & kind)) ? DYNAMIC
+                                                        : kinds | kind;
+        }
+    }
+
+    int32_t size() const { return conds.size(); }
+
+    //-------------------------------------------------------------------------
+
+    template <int Kinds>
+    class Static {
+        const ConditionSet& s;
+    public:
+        Static(const ConditionSet& s) : s(s) {}
+
+        bool operator()(const PathState& path, int32_t index) const {
+            bool even = true;
+            if constexpr ((Kinds & PARITY) != 0) {
+                even &= path.bestPriority(index)%2 == EVEN;
+            }
+            if constexpr ((Kinds & ENERGY) != 0) {
+                even &= path.cycleWeight(index) >= s.energy;
+            }
+            if constexpr ((Kinds & MEANPAYOFF) != 0) {
+                even &= (__int128)s.q*path.cycleWeight(index)
+                     >= (__int128)s.p*path.cycleLength(index);
+            }
+            return even != (s.playerSAT == ODD);
+        }
+    };
+
+    class Dynamic {
+        const ConditionSet& s;
+    public:
+        Dynamic(const ConditionSet& s) : s(s) {}
+
+        bool operator()(const PathState& path, int32_t index) const {
+            bool all = s.playerSAT == EVEN;
+            for (WinningCondition* c : s.conds) {
+                if (c->satisfy(path,index) != all) return !all;
+            }
+            return all;
+        }
+    };
+
+    //-------------------------------------------------------------------------
+    // Calls f with the evaluator of this set; f must return the same type
+    // for all of them.
+
+    template <typename F>
+    auto visit(F&& f) const {
+        switch (kinds) {
+            case 0:                     return f(Static<0>(*this));
+            case PARITY:                return f(Static<PARITY>(*this));
+            case ENERGY:                return f(Static<ENERGY>(*this));
+            case MEANPAYOFF:            return f(Static<MEANPAYOFF>(*this));
+            case PARITY|ENERGY:         return f(Static<PARITY|ENERGY>(*this));
+            case PARITY|MEANPAYOFF:
+                return f(Static<PARITY|MEANPAYOFF>(*this));
+            case ENERGY|MEANPAYOFF:
+                return f(Static<ENERGY|MEANPAYOFF>(*this));
+            case PARITY|ENERGY|MEANPAYOFF:
+                return f(Static<PARITY|ENERGY|MEANPAYOFF>(*this));
+            default:                    return f(Dynamic(*this));
+        }
+    }
+};
+
+#endif // CONDITION_SET_H
@@ -0,0 +1,113 @@
+/*
+ * Main authors:
+ *    Gonzalo Hernandez <gonzalo.hernandez@monash>
+ *    <gonzalo.hernandez@udenar.edu.co>
+ *
+ * Contributing authors:
+ *    Guido Tack <guido.tack@monash.edu>
+ *    Julian Gutierrez <J.Gutierrez@sussex.ac.uk>
+ *
+ * This file is part of NOCQ (a CP Toolchain for parity games with quantitative
+ * conditions).
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public License,
+ * v. 2.0. If a copy of the MPL was not distributed with this file, You can get
+ * one at https://mozilla.org/MPL/2.0/.
+ *
+ *-----------------------------------------------------------------------------
+ */
+#ifndef CYCLE_CHECK_H
+#define CYCLE_CHECK_H
+
+#ifndef WINNING_CONDITIONS_H
+#include "winning_conditions.h"
+#endif
+
+#include <vector>
+
+//=============================================================================
+// Base of the polynomial replacements for the path enumeration of the NOC
+// propagators. Backends pass the state of every edge (1 true, 0 undecided,
+// -1 false) and get back cuts: 'edge' must be false because the 'reason'
+// edges are true. A cut on a true edge is a conflict.
+
+class CycleCheck {
+public:
+    struct Cut {
+        int32_t edge;
+        std::vector<int32_t> reason;
+    };
+
+protected:
+    Game& g;
+    parity_type playerSAT;
+    const std::vector<int8_t>* state = nullptr;
+
+    std::vector<int32_t> from;          // BFS edge from init, -1 at init
+    std::vector<int32_t> markR;         // per check()
+    std::vector<int32_t> markE;         // per cut
+    int32_t round = 0, listed = 0;
+
+    std::vector<int32_t> reached;
+
+    bool isTrue(int32_t e) const { return (*state)[e] == 1; }
+    bool isReached(int32_t v) const { return markR[v] == round; }
+
+    //-------------------------------------------------------------------------
+
+    Cut& newCut(int32_t e, std::vector<Cut>& cuts) {
+        cuts.push_back(Cut());
+        cuts.back().edge = e;
+        markE[e] = ++listed;
+        return cuts.back();
+    }
+
+    void addEdge(int32_t e, Cut& cut) {
+        if (markE[e] == listed) return;
+        markE[e] = listed;
+        cut.reason.push_back(e);
+    }
+
+    void addInitPath(int32_t v, Cut& cut) {
+        for (; from[v] >= 0; v = g.sources[from[v]]) addEdge(from[v], cut);
+    }
+
+    //-------------------------------------------------------------------------
+    // Starts a check: vertices reachable from init through true edges.
+
+    void reach(const std::vector<int8_t>& edgeState) {
+        state = &edgeState;
+        round++;
+        reached.clear();
+        markR[g.init] = round;
+        from[g.init] = -1;
+        reached.push_back(g.init);
+        for (size_t q=0; q<reached.size(); q++) {
+            int32_t v = reached[q];
+            for (size_t j=0; j<g.outs[v].size(); j++) {
+                int32_t e = g.outs[v][j];
+                int32_t w = g.targets[e];
+                if (!isTrue(e) || markR[w] == round) continue;
+                markR[w] = round;
+                from[w] = e;
+                reached.push_back(w);
+            }
+        }
+    }
+
+public:
+    CycleCheck(Game& g, parity_type playerSAT)
+    :   g(g), playerSAT(playerSAT),
+        from(g.nvertices), markR(g.nvertices,0), markE(g.nedges,0)
+    {
+    }
+    virtual ~CycleCheck() = default;
+
+    //-------------------------------------------------------------------------
+    // Returns false when a true edge had to be cut (conflict).
+
+    virtual bool check(const std::vector<int8_t>& edgeState,
+                       std::vector<Cut>& cuts) = 0;
+};
+
+#endif // CYCLE_CHECK_H
@@ -0,0 +1,121 @@
+/*
+ * Main authors:
+ *    Gonzalo Hernandez <gonzalo.hernandez@monash>
+ *    <gonzalo.hernandez@udenar.edu.co>
+ *
+ * Contributing authors:
+ *    Guido Tack <guido.tack@monash.edu>
+ *    Julian Gutierrez <J.Gutierrez@sussex.ac.uk>
+ *
+ * This file is part of NOCQ (a CP Toolchain for parity games with quantitative
+ * conditions).
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public License,
+ * v. 2.0. If a copy of the MPL was not distributed with this file, You can get
+ * one at https://mozilla.org/MPL/2.0/.
+ *
+ *-----------------------------------------------------------------------------
+ */
+#ifndef CYCLE_CHECKS_H
+#define CYCLE_CHECKS_H
+
+#ifndef PARITY_CYCLES_H
+#include "parity_cycles.h"
+#endif
+
+#ifndef WEIGHT_CYCLES_H
+#include "weight_cycles.h"
+#endif
+
+//=============================================================================
+// The cycle checks a NOC propagator runs instead of enumerating paths for
+// some of its conditions. Cuts of different checks on the same edge are
+// reported once.
+
+class CycleChecks : public CycleCheck {
+private:
+    std::vector<CycleCheck*> checks;
+    std::vector<Cut> found;
+    std::vector<int32_t> markCut;
+    int32_t calls = 0;
+
+    static CycleCheck* checkFor(Game& g, WinningCondition* condition,
+                                parity_type playerSAT, bool parityScc,
+                                bool weightCycles)
+    {
+        if (parityScc && dynamic_cast<ParityCondition*>(condition)) {
+            return new ParityCycles(g, playerSAT);
+        }
+        if (!weightCycles) return nullptr;
+        EnergyCondition* energy = dynamic_cast<EnergyCondition*>(condition);
+        if (energy && energy->getThreshold() == 0) {
+            return new WeightCycles(g, playerSAT, 0, 1);
+        }
+        MeanPayoffCondition* mp = dynamic_cast<MeanPayoffCondition*>(condition);
+        if (mp) {
+            int64_t p, q;
+            mp->getFraction(p, q);
+            return new WeightCycles(g, playerSAT, p, q);
+        }
+        return nullptr;
+    }
+
+public:
+    CycleChecks(Game& g, parity_type playerSAT)
+    :   CycleCheck(g, playerSAT), markCut(g.nedges,0)
+    {
+    }
+    ~CycleChecks() override {
+        for (CycleCheck* c : checks) delete c;
+    }
+
+    //-------------------------------------------------------------------------
+    // Splits the conditions of a NOC propagator. Returns the checks that
+    // replace some of them, or nullptr; 'rest' keeps what the path
+    // enumeration must still verify. For ODD only a lone condition
+    // qualifies, since its conditions are disjunctive.
+
+    static CycleChecks* create(Game& g, vec<WinningCondition*>& conditions,
+                               parity_type playerSAT, bool parityScc,
+                               bool weightCycles, vec<WinningCondition*>& rest)
+    {
+        rest.clear();
+        if (playerSAT == ODD && conditions.size() != 1) {
+            for (size_t i=0; i<conditions.size(); i++) rest.push(conditions[i]);
+            return nullptr;
+        }
+        CycleChecks* checks = new CycleChecks(g, playerSAT);
+        for (size_t i=0; i<conditions.size(); i++) {
+            CycleCheck* c = checkFor(g, conditions[i], playerSAT, parityScc,
+                                     weightCycles);
+            if (c) checks->checks.push_back(c);
+            else rest.push(conditions[i]);
+        }
+        if (checks->checks.empty()) {
+            delete checks;
+            return nullptr;
+        }
+        return checks;
+    }
+
+    //-------------------------------------------------------------------------
+
+    bool check(const std::vector<int8_t>& edgeState,
+               std::vector<Cut>& cuts) override
+    {
+        calls++;
+        for (CycleCheck* c : checks) {
+            found.clear();
+            bool ok = c->check(edgeState, found);
+            for (size_t i=0; i<found.size(); i++) {
+                if (markCut[found[i].edge] == calls) continue;
+                markCut[found[i].edge] = calls;
+                cuts.push_back(std::move(found[i]));
+            }
+            if (!ok) return false;
+        }
+        return true;
+    }
+};
+
+#endif // CYCLE_CHECKS_H
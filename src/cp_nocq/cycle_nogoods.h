@@ -0,0 +1,134 @@
+/*
+ * Main authors:
+ *    Gonzalo Hernandez <gonzalo.hernandez@monash>
+ *    <gonzalo.hernandez@udenar.edu.co>
+ *
+ * Contributing authors:
+ *    Guido Tack <guido.tack@monash.edu>
+ *    Julian Gutierrez <J.Gutierrez@sussex.ac.uk>
+ *
+ * This file is part of NOCQ (a CP Toolchain for parity games with quantitative
+ * conditions).
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public License,
+ * v. 2.0. If a copy of the MPL was not distributed with this file, You can get
+ * one at https://mozilla.org/MPL/2.0/.
+ *
+ *-----------------------------------------------------------------------------
+ */
+#ifndef CYCLE_NOGOODS_H
+#define CYCLE_NOGOODS_H
+
+#ifndef GAME_H
+#include "../utils/game.h"
+#endif
+
+#include <vector>
+#include <unordered_set>
+
+//=============================================================================
+// Bad cycles found by a NOC propagator, kept for the rest of the search. A
+// cycle that violates the conditions does so wherever it is reached from, so
+// "not all of its edges" is a valid nogood: a solution with the cycle active
+// but unreachable stays a solution once the unreachable part is switched off.
+//
+// Cycles are deduplicated by an order-free hash of their edge sets; a hash
+// collision only loses a nogood. Each nogood watches two edges that are not
+// true, as in two-watched-literal propagation. The enumeration stays in place,
+// so a propagation the watches miss after a backjump is still found there.
+
+class CycleNogoods {
+private:
+    Game& g;
+    std::vector<std::vector<int32_t>> nogoods;  // [0] and [1] are watched
+    std::vector<std::vector<int32_t>> watchers; // nogoods watching each edge
+    std::unordered_set<uint64_t> seen;
+
+    static uint64_t mix(uint64_t x) {           // splitmix64 finaliser
+        x += 0x9e3779b97f4a7c15ULL;
+        x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+        return x ^ (x >> 31);
+    }
+
+public:
+    int64_t stored = 0;
+    int64_t fired = 0;
+
+    CycleNogoods(Game& g) : g(g), watchers(g.nedges) {}
+
+    //-------------------------------------------------------------------------
+    // Records the cycle E[index..], whose last edge is being cut while the
+    // others are true. 'order(e)' ranks true edges by assignment time, so the
+    // second watch goes to the edge a backjump undoes first. Returns false
+    // when the cycle was already known or is a self-loop.
+
+    template <typename Order>
+    bool add(const vec<int32_t>& E, int32_t index, Order order) {
+        int32_t n = E.size() - index;
+        if (n < 2) return false;
+
+        uint64_t sum = 0, xr = 0;
+        for (int32_t i=index; i<(int32_t)E.size(); i++) {
+            uint64_t h = mix(E[i]);
+            sum += h;
+            xr ^= h;
+        }
+        if (!seen.insert(mix(sum ^ mix(xr + n))).second) return false;
+
+        std::vector<int32_t> c;
+        c.reserve(n);
+        c.push_back(E.last());
+        int32_t latest = index;
+        for (int32_t i=index; i+1<(int32_t)E.size(); i++) {
+            if (order(E[i]) > order(E[latest])) latest = i;
+        }
+        c.push_back(E[latest]);
+        for (int32_t i=index; i+1<(int32_t)E.size(); i++) {
+            if (i != latest) c.push_back(E[i]);
+        }
+
+        watchers[c[0]].push_back(nogoods.size());
+        watchers[c[1]].push_back(nogoods.size());
+        nogoods.push_back(std::move(c));
+        stored++;
+        return true;
+    }
+
+    const std::vector<int32_t>& edges(int32_t id) const { return nogoods[id]; }
+
+    //-------------------------------------------------------------------------
+    // Edge e has become true. Nogoods watching it move the watch to another
+    // edge that is not true, or call 'cut(id, f)' to fix their last non-true
+    // edge f to false (a conflict if f is true too). Returns false on
+    // conflict.
+
+    template <typename IsTrue, typename IsFalse, typename Cut>
+    bool onTrue(int32_t e, IsTrue isTrue, IsFalse isFalse, Cut cut) {
+        std::vector<int32_t>& ws = watchers[e];
+        size_t i = 0, j = 0;
+        bool ok = true;
+        for (; i<ws.size() && ok; i++) {
+            int32_t id = ws[i];
+            std::vector<int32_t>& c = nogoods[id];
+            if (c[0] == e) std::swap(c[0], c[1]);
+            if (isFalse(c[0])) { ws[j++] = id; continue; }
+
+            size_t k = 2;
+            while (k < c.size() && isTrue(c[k])) k++;
+            if (k < c.size()) {
+                std::swap(c[1], c[k]);
+                watchers[c[1]].push_back(id);
+                continue;
+            }
+            ws[j++] = id;
+            fired++;
+            ok = cut(id, c[0]);
+        }
+        for (; i<ws.size(); i++) ws[j++] = ws[i];
+        ws.resize(j);
+        return ok;
+    }
+};
+
+#endif // CYCLE_NOGOODS_H
@@ -0,0 +1,85 @@
+/*
+ * Main authors:
+ *    Gonzalo Hernandez <gonzalo.hernandez@monash>
+ *    <gonzalo.hernandez@udenar.edu.co>
+ *
+ * Contributing authors:
+ *    Guido Tack <guido.tack@monash.edu>
+ *    Julian Gutierrez <J.Gutierrez@sussex.ac.uk>
+ *
+ * This file is part of NOCQ (a CP Toolchain for parity games with quantitative
+ * conditions).
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public License,
+ * v. 2.0. If a copy of the MPL was not distributed with this file, You can get
+ * one at https://mozilla.org/MPL/2.0/.
+ *
+ *-----------------------------------------------------------------------------
+ */
+#ifndef INIT_PATHS_H
+#define INIT_PATHS_H
+
+#ifndef GAME_H
+#include "../utils/game.h"
+#endif
+
+#include <vector>
+
+//=============================================================================
+// Shortest paths of true edges from init, for explanations: a bad cycle only
+// needs some committed path that reaches it, not the one the enumeration
+// happened to follow. Built on demand, once per propagation.
+
+class InitPaths {
+private:
+    Game& g;
+    std::vector<int32_t> from;          // BFS edge into a vertex, -1 at init
+    std::vector<int32_t> depth;
+    std::vector<int32_t> mark;
+    std::vector<int32_t> queue;
+    int32_t round = 0;
+    bool built = false;
+
+public:
+    InitPaths(Game& g)
+    :   g(g), from(g.nvertices), depth(g.nvertices), mark(g.nvertices,0)
+    {
+    }
+
+    // Forget the tree; the true edges have changed.
+    void reset() { built = false; }
+
+    template <typename IsTrue>
+    void build(IsTrue isTrue) {
+        if (built) return;
+        built = true;
+        round++;
+        queue.assign(1, g.init);
+        mark[g.init] = round;
+        from[g.init] = -1;
+        depth[g.init] = 0;
+        for (size_t q=0; q<queue.size(); q++) {
+            int32_t v = queue[q];
+            for (size_t j=0; j<g.outs[v].size(); j++) {
+                int32_t e = g.outs[v][j];
+                int32_t w = g.targets[e];
+                if (mark[w] == round || !isTrue(e)) continue;
+                mark[w] = round;
+                from[w] = e;
+                depth[w] = depth[v]+1;
+                queue.push_back(w);
+            }
+        }
+    }
+
+    bool reaches(int32_t v) const { return mark[v] == round; }
+    int32_t getDepth(int32_t v) const { return depth[v]; }
+
+    // Edges of the path to v, from v backwards.
+    template <typename Add>
+    void path(int32_t v, Add add) const {
+        for (; from[v] >= 0; v = g.sources[from[v]]) add(from[v]);
+    }
+};
+
+#endif // INIT_PATHS_H
@@ -0,0 +1,119 @@
+/*
+ * Main authors:
+ *    Gonzalo Hernandez <gonzalo.hernandez@monash>
+ *    <gonzalo.hernandez@udenar.edu.co>
+ *
+ * Contributing authors:
+ *    Guido Tack <guido.tack@monash.edu>
+ *    Julian Gutierrez <J.Gutierrez@sussex.ac.uk>
+ *
+ * This file is part of NOCQ (a CP Toolchain for parity games with quantitative
+ * conditions).
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public License,
+ * v. 2.0. If a copy of the MPL was not distributed with this file, You can get
+ * one at https://mozilla.org/MPL/2.0/.
+ *
+ *-----------------------------------------------------------------------------
+ */
+#ifndef MP_BOUND_H
+#define MP_BOUND_H
+
+#ifndef WINNING_CONDITIONS_H
+#include "winning_conditions.h"
+#endif
+
+#ifndef EPM_H
+#include "../utils/epm.h"
+#endif
+
+#include <vector>
+#include <stdexcept>
+
+//=============================================================================
+// Bound for a mean-payoff condition of EVEN, checked on the residual game:
+// the whole arena without the EVEN edges already fixed to false. A solution
+// is a positional strategy of EVEN in it whose reachable cycles all have
+// mean >= p/q, so if ODD wins the mean-payoff game from init there is none,
+// long before the enumeration closes a bad cycle.
+//
+// The game is solved as an energy game on the weights q*w-p. Its progress
+// measure is the dual certificate of the relaxation: finite credits are
+// potentials, and the vertices at TOP are ODD's region. That region is a trap
+// for EVEN, so the reason is only the false EVEN edges leaving it; restoring
+// any other edge leaves ODD's strategy winning. Removing EVEN edges only
+// raises the measure, so a solve starts from that of the last check when the
+// caller knows no edge was restored since, or else from the whole arena.
+//
+// This stands in for an LP relaxation through Chuffed's MIP module, which
+// switches itself off when there is no objective variable, as in every NOC
+// model.
+
+class MeanPayoffBound {
+private:
+    Game& g;
+    std::vector<int64_t> weight;        // q*w-p, one per edge
+    std::vector<bool> usable;           // edges of the residual game
+    EnergyLifting<int64_t>* lifting = nullptr;
+    std::vector<int64_t> whole;         // measure of the whole arena
+    std::vector<int64_t> last;          // ... and of the last check
+
+public:
+    static constexpr int64_t TOP = EnergyLifting<int64_t>::TOP;
+
+    int64_t checks = 0;
+    int64_t conflicts = 0;
+
+    MeanPayoffBound(Game& g, MeanPayoffCondition& mp)
+    :   g(g), weight(g.nedges), usable(g.nedges, true)
+    {
+        int64_t p, q;
+        mp.getFraction(p,q);
+        const __int128 limit = INT64_MAX/4;
+        for (int32_t e=0; e<g.nedges; e++) {
+            __int128 w = (__int128)q*g.weights[e]-p;
+            if (w > limit || -w > limit) {
+                throw std::overflow_error("MeanPayoffBound: weight out of range");
+            }
+            weight[e] = static_cast<int64_t>(w);
+        }
+        lifting = new EnergyLifting<int64_t>(g, weight, nullptr, &usable);
+        whole = lifting->solve();
+    }
+
+    ~MeanPayoffBound() { delete lifting; }
+    MeanPayoffBound(const MeanPayoffBound&) = delete;
+    MeanPayoffBound& operator=(const MeanPayoffBound&) = delete;
+
+    int64_t lifts() const { return lifting->lifts; }
+
+    //-------------------------------------------------------------------------
+    // False when ODD wins the residual game from init. 'isFalse(e)' tells the
+    // EVEN edges fixed to false; ODD keeps every edge, which only helps it.
+    // 'warm' when every edge false at the last check still is.
+
+    template <typename IsFalse>
+    bool check(IsFalse isFalse, bool warm=false) {
+        checks++;
+        for (int32_t e=0; e<g.nedges; e++) {
+            usable[e] = g.owners[g.sources[e]] != EVEN || !isFalse(e);
+        }
+        last = lifting->solve(warm ? &last : &whole);
+        if (last[g.init] < TOP) return true;
+        conflicts++;
+        return false;
+    }
+
+    //-------------------------------------------------------------------------
+    // After a failed check, the false EVEN edges leaving ODD's region.
+
+    template <typename Emit>
+    void explain(Emit emit) const {
+        const std::vector<int64_t>& credit = lifting->getCredits();
+        for (int32_t e=0; e<g.nedges; e++) {
+            if (!usable[e] && credit[g.sources[e]] == TOP) emit(e);
+        }
+    }
+};
+
+#endif // MP_BOUND_H
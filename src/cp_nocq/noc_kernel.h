@@ -0,0 +1,263 @@
+/*
+ * Main authors:
+ *    Gonzalo Hernandez <gonzalo.hernandez@monash>
+ *    <gonzalo.hernandez@udenar.edu.co>
+ *
+ * Contributing authors:
+ *    Guido Tack <guido.tack@monash.edu>
+ *    Julian Gutierrez <J.Gutierrez@sussex.ac.uk>
+ *
+ * This file is part of NOCQ (a CP Toolchain for parity games with quantitative
+ * conditions).
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public License,
+ * v. 2.0. If a copy of the MPL was not distributed with this file, You can get
+ * one at https://mozilla.org/MPL/2.0/.
+ *
+ *-----------------------------------------------------------------------------
+ */
+#ifndef NOC_KERNEL_H
+#define NOC_KERNEL_H
+
+#ifndef PATH_STATE_H
+#include "path_state.h"
+#endif
+
+#ifndef INIT_PATHS_H
+#include "init_paths.h"
+#endif
+
+#ifndef CYCLE_CHECK_H
+#include "cycle_check.h"
+#endif
+
+#include <vector>
+#include <algorithm>
+
+enum noc_status {NOC_STAY, NOC_CONFLICT, NOC_DONE};
+
+//=============================================================================
+// Cycle filtering shared by every NOC propagator. The solver side is given by
+// an adapter type, usually the propagator itself, with:
+//
+//   bool isTrueEdge(e), isFalseEdge(e)     the edge is committed / excluded
+//   bool isNewEdge(e)                      fixed to true since the last call
+//   bool leadsToNew(v)                     v reaches the source of a new edge
+//   bool isRootEdge(e)                     fixed at the root of the search
+//   noc_status closeCycle(index, bad)      the last edge of the path closes a
+//                                          cycle from 'index'; cut it if bad
+//
+// Calls are resolved at compile time, so every backend gets the enumeration
+// inlined over its own literals.
+//
+// With the memo, a vertex entered by an edge between two strongly connected
+// components of the non-false edges is enumerated once per call: nothing
+// reachable from it leads back to the path, so its subtree closes the same
+// cycles whatever the path was. Components of an earlier, larger graph stay
+// valid: they are computed on the whole game, and refined by backends that
+// propagate at the root.
+
+template <class Adapter>
+class NOCKernel {
+private:
+    Game& g;
+    vec<char> freshAt;                  // freshAt[k]: path to V[k] uses a new edge
+
+    bool memo;                          // skip repeated component entries
+    std::vector<int32_t> comp;          // component of each vertex
+    std::vector<int32_t> order, low, stack;   // Tarjan state
+    std::vector<std::pair<int32_t,size_t>> frames;
+    vec<char> crossAt;                  // V[k] entered from another component
+    std::vector<int32_t> done;          // done[v]==round: v's subtree enumerated
+    std::vector<char> doneFresh;        // ... checking every cycle in it
+    int32_t round = 0;
+
+    bool shortReasons;                  // cycle + shortest path from init
+    InitPaths paths;
+    vec<int32_t> used;                  // used[e]==usedStamp: e is in the reason
+    int32_t usedStamp = 0;
+
+    template <typename Emit>
+    void addReason(Adapter& a, int32_t e, Emit& emit) {
+        if (used[e] == usedStamp) return;
+        used[e] = usedStamp;
+        if (shortReasons && a.isRootEdge(e)) return;
+        emit(e);
+    }
+
+public:
+    PathState path;                     // DFS frames, reused by every call
+    int64_t entries = 0;                // component entries enumerated
+    int64_t pruned = 0;                 // ... and skipped by the memo
+
+    NOCKernel(Game& g, bool shortReasons=false, bool memo=false)
+    :   g(g), memo(memo), shortReasons(shortReasons), paths(g), path(g)
+    {
+        used.growTo(g.nedges, 0);
+        if (memo) {
+            comp.resize(g.nvertices);
+            order.resize(g.nvertices);
+            low.resize(g.nvertices);
+            done.resize(g.nvertices, 0);
+            doneFresh.resize(g.nvertices, 0);
+            tarjan([](int32_t) { return false; });
+        }
+    }
+
+    bool hasMemo() const { return memo; }
+
+    // The true edges have changed since the last explanation.
+    void reset() { paths.reset(); }
+
+    //-------------------------------------------------------------------------
+    // Iterative Tarjan over the edges that are not removed, for the memo.
+
+    template <typename Removed>
+    void tarjan(const Removed& removed) {
+        int32_t counter = 0, ncomps = 0;
+        std::fill(order.begin(), order.end(), -1);
+        std::fill(comp.begin(), comp.end(), -1);
+
+        for (int32_t s=0; s<g.nvertices; s++) {
+            if (order[s] != -1) continue;
+            order[s] = low[s] = counter++;
+            stack.push_back(s);
+            frames.push_back({s,0});
+
+            while (!frames.empty()) {
+                int32_t v = frames.back().first;
+                size_t& i = frames.back().second;
+                if (i < g.outs[v].size()) {
+                    int32_t e = g.outs[v][i++];
+                    int32_t w = g.targets[e];
+                    if (removed(e)) continue;
+                    if (order[w] == -1) {
+                        order[w] = low[w] = counter++;
+                        stack.push_back(w);
+                        frames.push_back({w,0});
+                    }
+                    else if (comp[w] == -1) {
+                        low[v] = std::min(low[v], order[w]);
+                    }
+                    continue;
+                }
+
+                frames.pop_back();
+                if (!frames.empty()) {
+                    int32_t u = frames.back().first;
+                    low[u] = std::min(low[u], low[v]);
+                }
+                if (low[v] != order[v]) continue;
+
+                int32_t w;
+                do {
+                    w = stack.back(); stack.pop_back();
+                    comp[w] = ncomps;
+                } while (w != v);
+                ncomps++;
+            }
+        }
+    }
+
+    // Recomputes the components without the false edges; only at the root.
+    void components(Adapter& a) {
+        if (memo) tarjan([&](int32_t e) { return a.isFalseEdge(e); });
+    }
+
+    //-------------------------------------------------------------------------
+    // Depth-first enumeration of the paths of true edges from init, with the
+    // path as the frame stack. Cycles are closed through undecided edges too.
+    // Unless 'fresh', only cycles that use a new edge or a vertex leading to
+    // one are checked again.
+
+    template <class Satisfy>
+    noc_status filter(Adapter& a, const Satisfy& satisfy, bool fresh=true) {
+        round++;
+        path.clear();
+        freshAt.clear();
+        crossAt.clear();
+        path.pushVertex(g.init);
+        freshAt.push(fresh);
+        crossAt.push(false);
+
+        while (path.V.size()) {
+            int32_t k = path.V.size()-1;
+            int32_t v = path.V[k];
+            if (path.next[k] == (int32_t)g.outs[v].size()) {
+                if (crossAt[k]) {
+                    done[v] = round;
+                    doneFresh[v] = freshAt[k];
+                }
+                path.popVertex();
+                freshAt.pop();
+                crossAt.pop();
+                if (k > 0) path.popEdge();
+                continue;
+            }
+            int32_t e = g.outs[v][path.next[k]++];
+            if (a.isFalseEdge(e)) continue;
+
+            int32_t w = g.targets[e];
+            bool f = freshAt[k] || a.isNewEdge(e);
+            if (!f && !a.leadsToNew(w)) continue;
+
+            int32_t index = path.find(w);
+            if (index >= 0) {
+                if (!f) continue;
+                path.pushEdge(e);
+                noc_status status = a.closeCycle(index, !satisfy(path,index));
+                path.popEdge();
+                if (status != NOC_STAY) return status;
+            }
+            else if (a.isTrueEdge(e)) {
+                bool cross = memo && comp[w] != comp[v];
+                if (cross) {
+                    if (done[w] == round && (doneFresh[w] || !f)) {
+                        pruned++;
+                        continue;
+                    }
+                    entries++;
+                }
+                path.pushEdge(e);
+                path.pushVertex(w);
+                freshAt.push(f);
+                crossAt.push(cross);
+            }
+        }
+        return NOC_STAY;
+    }
+
+    //-------------------------------------------------------------------------
+    // Edges whose conjunction forbids the last edge of the path, which closes
+    // the cycle from 'index'. Short reasons replace the enumeration prefix by
+    // the shortest path of true edges from init to the closest vertex of the
+    // cycle, and leave out edges fixed at the root.
+
+    template <typename Emit>
+    void explain(Adapter& a, int32_t index, Emit emit) {
+        if (!shortReasons) {
+            for (size_t i=0; i+1<path.E.size(); i++) emit(path.E[i]);
+            return;
+        }
+        paths.build([&](int32_t e) { return a.isTrueEdge(e); });
+        usedStamp++;
+        used[path.E.last()] = usedStamp;
+        int32_t x = path.V[index];
+        for (size_t i=index; i+1<path.E.size(); i++) {
+            addReason(a, path.E[i], emit);
+            int32_t v = path.V[i+1];
+            if (paths.getDepth(v) < paths.getDepth(x)) x = v;
+        }
+        paths.path(x, [&](int32_t e) { addReason(a, e, emit); });
+    }
+
+    // Edges whose conjunction forbids the edge of a cut.
+    template <typename Emit>
+    void explain(Adapter& a, const CycleCheck::Cut& cut, Emit emit) {
+        usedStamp++;
+        used[cut.edge] = usedStamp;
+        for (int32_t e : cut.reason) addReason(a, e, emit);
+    }
+};
+
+#endif // NOC_KERNEL_H
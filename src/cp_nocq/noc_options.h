@@ -0,0 +1,49 @@
+/*
+ * Main authors:
+ *    Gonzalo Hernandez <gonzalo.hernandez@monash>
+ *    <gonzalo.hernandez@udenar.edu.co>
+ *
+ * Contributing authors:
+ *    Guido Tack <guido.tack@monash.edu>
+ *    Julian Gutierrez <J.Gutierrez@sussex.ac.uk>
+ *
+ * This file is part of NOCQ (a CP Toolchain for parity games with quantitative
+ * conditions).
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public License,
+ * v. 2.0. If a copy of the MPL was not distributed with this file, You can get
+ * one at https://mozilla.org/MPL/2.0/.
+ *
+ *-----------------------------------------------------------------------------
+ */
+#ifndef NOC_OPTIONS_H
+#define NOC_OPTIONS_H
+
+#ifndef GAME_H
+#include "../utils/game.h"
+#endif
+
+//=============================================================================
+// Options of the NOC models. Every backend takes the same set and reads the
+// ones it supports.
+
+struct NOCOptions {
+    int         printtype       = 0;
+    parity_type playerSAT       = EVEN;
+    double      precision       = 0;            // mpg-search threshold ladder
+    bool        parityScc       = false;        // parity by layered SCCs
+    bool        weightCycles    = false;        // energy/MP by negative cycles
+    bool        shortReasons    = false;        // minimal NOC explanations
+    bool        cycleNogoods    = false;        // keep bad cycles as nogoods
+    bool        sccMemo         = false;        // enumerate SCC entries once
+    bool        aliasEdges      = false;        // edges share source literals
+    amo_type    amo             = AMO_SEQ;      // one edge per PLAYER vertex
+    bool        pmModel         = false;        // parity by progress measures
+    int32_t     mpBound         = 0;            // residual MPG bound period
+    bool        symmetry        = false;        // LDSB on interchangeable blocks
+    branch_type branch          = BRANCH_SCAN;  // PLAYER vertex order
+    bool        branchPriority  = false;        // good priorities first
+    warm_type   warmStart       = WARM_NONE;    // first descent from a strategy
+};
+
+#endif // NOC_OPTIONS_H
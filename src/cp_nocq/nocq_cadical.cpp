@@ -20,9 +20,31 @@
 #include "cadical.hpp"
 #include <queue>
 #include <unordered_map>
+#include <sstream>
+#include <cmath>
 
-#ifndef WINNING_CONDITIONS_H
-#include "winning_conditions.h"
+#ifndef NOC_OPTIONS_H
+#include "noc_options.h"
+#endif
+
+#ifndef CONDITION_SET_H
+#include "condition_set.h"
+#endif
+
+#ifndef CYCLE_CHECKS_H
+#include "cycle_checks.h"
+#endif
+
+#ifndef NOC_KERNEL_H
+#include "noc_kernel.h"
+#endif
+
+#ifndef CYCLE_NOGOODS_H
+#include "cycle_nogoods.h"
+#endif
+
+#ifndef AMO_H
+#include "amo.h"
 #endif
 
 namespace CaDiCaL {
@@ -39,9 +61,26 @@ private:
     vec<BoolSAT>& E;
     vec<int>    assigns;
     parity_type playerSAT;
-    vec<WinningCondition*> winConditions;
+    ConditionSet conds;
+    vec<BoolSAT>& T;                    // T[k]: mean >= levels[k]/levelDen
+    vec<int64_t>& levels;
+    int64_t levelDen;
+
+    CycleChecks* cycles;                // polynomial cycle checks, or nullptr
+    std::vector<int8_t> edgeState;
+    std::vector<CycleCheck::Cut> cuts;
+
+    NOCKernel<NOCPropagator> kernel;
+    PathState& path;
+    friend class NOCKernel<NOCPropagator>;
+    vec<char> root;                     // assigned at decision level 0
 
     size_t reasonLit;
+    size_t clauseLit = 0;
+    std::queue<int32_t> newNogoods;     // to hand over as external clauses
+
+    vec<int32_t> amoEdge;               // amoEdge[var]: PLAYER edge, or -1
+    std::vector<int32_t> fixedEdges;    // ... fixed to true, to cut siblings
 
     std::queue<int> propQueue;
     std::unordered_map<int, vec<int>> propReasons;
@@ -54,15 +93,40 @@ private:
     bool isTrue(int v)  { return assigns[v] == 1; }
 
 public:
+    CycleNogoods* nogoods;              // bad cycles seen so far, or nullptr
+    int64_t explanations = 0;
+    int64_t reasonLits = 0;
+    int64_t amoCuts = 0;
+
     NOCPropagator(Game& game, vec<BoolSAT>& V, vec<BoolSAT>& E, 
-        parity_type playerSAT, vec<WinningCondition*> winConditions)
-    : g(game), V(V), E(E), playerSAT(playerSAT), winConditions(winConditions), 
-        reasonLit(0), assigns(g.nvertices+g.nedges+1,0)
+        parity_type playerSAT, vec<WinningCondition*> winConditions,
+        vec<BoolSAT>& T, vec<int64_t>& levels, int64_t levelDen,
+        CycleChecks* cycles=nullptr, bool shortReasons=false,
+        bool cycleNogoods=false, bool sccMemo=false, bool nativeAMO=false)
+    : g(game), V(V), E(E), assigns(g.nvertices+g.nedges+T.size()+1,0),
+        playerSAT(playerSAT), conds(winConditions,playerSAT),
+        T(T), levels(levels), levelDen(levelDen), cycles(cycles),
+        edgeState(g.nedges),
+        kernel(g,shortReasons,sccMemo), path(kernel.path),
+        reasonLit(0), nogoods(cycleNogoods ? new CycleNogoods(g) : nullptr)
     {
         trail.push();
+        root.growTo(assigns.size(), 0);
+        amoEdge.growTo(assigns.size(), -1);
+        for (int32_t e=0; nativeAMO && e<g.nedges; e++) {
+            int32_t v = g.sources[e];
+            if (g.owners[v] == playerSAT && g.outs[v].size() > 1) {
+                amoEdge[E[e]] = e;
+            }
+        }
+    }
+    //-------------------------------------------------------------------------
+    ~NOCPropagator() override {
+        delete cycles;
+        delete nogoods;
     }
     //-------------------------------------------------------------------------
-    ~NOCPropagator() override = default;
+    const NOCKernel<NOCPropagator>& getKernel() const { return kernel; }
     //-------------------------------------------------------------------------
     void notify_assignment(const std::vector<int> &lits) override {
         for (int lit : lits) {
@@ -70,6 +134,8 @@ public:
             if (assigns[v] != 0) continue;
             assigns[v] = (lit > 0) ? 1 : -1;
             trail.last().push(v);
+            if (trail.size() == 1) root[v] = 1;
+            if (lit > 0 && amoEdge[v] >= 0) fixedEdges.push_back(amoEdge[v]);
         }
     }
     //-------------------------------------------------------------------------
@@ -85,6 +151,8 @@ public:
             }
             trail.pop();
         }
+        // Queued literals were explained by assignments that may be gone.
+        propQueue = std::queue<int>();
     }
     //-------------------------------------------------------------------------
     bool cb_check_found_model (const std::vector<int> &model) override {
@@ -102,11 +170,34 @@ public:
             return lit;
         }
 
-        vec<int32_t> pathV;
-        vec<int32_t> pathE;
-        vec<int64_t> pathW;
+        if (!fixedEdges.empty()) {
+            cutSiblings();
+            if (!propQueue.empty()) {
+                int lit = propQueue.front();
+                propQueue.pop();
+                return lit;
+            }
+        }
 
-        filter(pathV,pathE,pathW,g.init,-1,true);
+        if (cycles) {
+            cutBadCycles();
+            if (conds.size() == 0 && T.size() == 0) {
+                if (!propQueue.empty()) {
+                    int lit = propQueue.front();
+                    propQueue.pop();
+                    return lit;
+                }
+                return 0;
+            }
+        }
+
+        if (propQueue.empty()) {
+            kernel.reset();
+            if (trail.size() == 1) kernel.components(*this);
+            conds.visit([&](const auto& satisfy) {
+                return kernel.filter(*this, satisfy);
+            });
+        }
 
         if (!propQueue.empty()) {
             int lit = propQueue.front();
@@ -127,82 +218,119 @@ public:
         return 0;
     }
     //-------------------------------------------------------------------------
+    // New cycle nogoods become permanent clauses; CaDiCaL watches them.
     bool cb_has_external_clause(bool &is_forgettable) override {
-        return false;
+        is_forgettable = false;
+        return !newNogoods.empty();
     }
     //-------------------------------------------------------------------------
     int cb_add_external_clause_lit() override {
+        const std::vector<int32_t>& c = nogoods->edges(newNogoods.front());
+        if (clauseLit < c.size()) return -E[c[clauseLit++]];
+        clauseLit = 0;
+        newNogoods.pop();
         return 0;
     }
     //-------------------------------------------------------------------------
-    int findVertex(int vertex,vec<int>& path) {
-        for (int i=0; i<path.size(); i++) {
-            if (path[i] == vertex) return i;
+    // Weakest asserted threshold the cycle mean falls below (-1 if none).
+    // Guards whose step has not set their level yet are skipped: CaDiCaL
+    // decides them too, and a cut under one would outlive its meaning.
+    int violatedLevel(int32_t index) {
+        if (levels.size() == 0) return -1;
+        // mean < levels[k]/levelDen, without dividing
+        __int128 weight = (__int128)levelDen*path.cycleWeight(index);
+        int64_t length = path.cycleLength(index);
+
+        int best = -1;
+        for (int k=0; k<levels.size(); k++) {
+            if (!isTrue(T[k]) || (__int128)levels[k]*length <= weight) continue;
+            if (best < 0 || levels[k] < levels[best]) best = k;
         }
-        return -1;
+        return best;
     }
     //-------------------------------------------------------------------------
-    bool satisfiedConditions(   vec<int32_t>& pathV, vec<int32_t>& pathE,
-                                vec<int64_t>& pathW, int32_t index) 
-    {
-        if (playerSAT==EVEN) {
-            for (size_t i=0; i<winConditions.size(); i++) {
-                if (!winConditions[i]->satisfy(pathV,pathE,pathW,index)) {
-                    return false;
-                }
-            }
-            return true;
-        }
-        else {
-            for (size_t i=0; i<winConditions.size(); i++) {
-                if (winConditions[i]->satisfy(pathV,pathE,pathW,index)) {
-                    return true;
+    // Adapter for the kernel.
+    bool isTrueEdge(int32_t e)  { return isTrue(E[e]); }
+    bool isFalseEdge(int32_t e) { return isFalse(E[e]); }
+    bool isNewEdge(int32_t e)   { return false; }
+    bool leadsToNew(int32_t v)  { return true; }
+    bool isRootEdge(int32_t e)  { return root[E[e]]; }
+    //-------------------------------------------------------------------------
+    // At most one out-edge per PLAYER vertex: the siblings of an edge fixed
+    // to true are cut, each explained by that edge alone. A true sibling is
+    // a conflict and goes out first.
+    void cutSiblings() {
+        for (int32_t e : fixedEdges) {
+            if (!isTrue(E[e])) continue;            // undone by a backtrack
+            int32_t v = g.sources[e];
+            for (size_t j=0; j<g.outs[v].size(); j++) {
+                int32_t f = g.outs[v][j];
+                if (f == e || isFalse(E[f])) continue;
+                int lit = -E[f];
+                vec<int>& reason = propReasons[lit];
+                reason.clear();
+                reason.push(lit);
+                reason.push(-E[e]);
+                amoCuts++;
+                if (isTrue(E[f])) {
+                    propQueue = std::queue<int>();
+                    propQueue.push(lit);
+                    fixedEdges.clear();
+                    return;
                 }
+                propQueue.push(lit);
             }
-            return false;
         }
+        fixedEdges.clear();
     }
     //-------------------------------------------------------------------------
-    bool filter(vec<int32_t>& pathV, vec<int32_t>& pathE, vec<int64_t>& pathW,
-        int32_t v, int32_t lastEdge, bool definedEdge) 
-    {
-        int index = findVertex(v,pathV);
-        if (index >= 0) {
-            if (!satisfiedConditions(pathV,pathE,pathW,index)) {
-                propReasons[-E[lastEdge]].clear();
-                for (size_t i=0; i<pathV.size(); i++) {
-                    propReasons[-E[lastEdge]].push( -E[pathE[i]] );
-                }
-                reasonLit = 0;
-                
-                propQueue.push(-E[lastEdge]);
-                if (isTrue(E[lastEdge])) {
-                    return true;
-                }
-                return false;
-            }
+    void cutBadCycles() {
+        for (int e=0; e<g.nedges; e++) {
+            edgeState[e] = isTrue(E[e]) ? 1 : isFalse(E[e]) ? -1 : 0;
         }
-        else if (definedEdge) {
-            pathV.push(v);
-            for (size_t i=0; i<g.outs[v].size(); i++) {
-                int32_t e = g.outs[v][i];
-                if (isFalse(E[e])) continue;
-                int w = g.targets[e];
-                int64_t acum = pathW.size() ? g.weights[e]+pathW.last()
-                                            : g.weights[e];
-                
-                pathE.push(e);
-                pathW.push(acum);
-                bool confl = filter(pathV, pathE, pathW, w, e, isTrue(E[e]));
-                pathW.pop();
-                pathE.pop();
-                if (confl) {
-                    return true;
-                }
-            }
-            pathV.pop();
+        cuts.clear();
+        cycles->check(edgeState, cuts);
+        for (size_t i=0; i<cuts.size(); i++) {
+            int lit = -E[cuts[i].edge];
+            vec<int>& reason = propReasons[lit];
+            reason.clear();
+            reason.push(lit);
+            kernel.explain(*this, cuts[i], [&](int32_t e) {
+                reason.push( -E[e] );
+            });
+            explanations++;
+            reasonLits += reason.size()-1;
+            propQueue.push(lit);
+            if (isTrue(E[cuts[i].edge])) return;
         }
-        return false;
+    }
+    //-------------------------------------------------------------------------
+    // The last edge of the path closes a cycle from 'index'; queue its
+    // negation, with the reason behind it, when the cycle is bad or falls
+    // below an asserted threshold.
+    noc_status closeCycle(int32_t index, bool bad) {
+        int level = -1;
+        if (!bad && (level = violatedLevel(index)) < 0) return NOC_STAY;
+
+        if (bad && nogoods &&
+            nogoods->add(path.E, index, [](int32_t) { return 0; })) {
+            newNogoods.push(nogoods->stored-1);
+        }
+
+        int32_t lastEdge = path.E.last();
+        vec<int>& reason = propReasons[-E[lastEdge]];
+        reason.clear();
+        reason.push( -E[lastEdge] );
+        kernel.explain(*this, index, [&](int32_t e) {
+            reason.push( -E[e] );
+        });
+        if (level >= 0) reason.push( -T[level] );
+        explanations++;
+        reasonLits += reason.size()-1;
+        reasonLit = 0;
+
+        propQueue.push(-E[lastEdge]);
+        return isTrue(E[lastEdge]) ? NOC_CONFLICT : NOC_STAY;
     }
 };
 
@@ -214,20 +342,38 @@ private:
     vec<BoolSAT> V;
     vec<BoolSAT> E;
     vec<WinningCondition*> winConditions;
-    int threshold;
     parity_type playerSAT;
 
+    double precision;
+    bool parityScc;
+    bool weightCycles;
+    bool shortReasons;
+    bool cycleNogoods;
+    bool sccMemo;
+    amo_type amo;
+    NOCPropagator* noc = nullptr;
+    vec<BoolSAT> T;                     // mean-payoff threshold ladder
+    vec<int64_t> levels;                // ... its thresholds times stepDen
+    int64_t stepNum = 1;                // precision as a decimal fraction
+    int64_t stepDen = 1;
+    std::string witness;
+
     int pool=0;
     Solver* solver;
 
     int newBoolVar ()           { pool += 1;    return pool; }
     int newBoolVars(int size)   { pool += size; return pool-size+1; }
 public:
+    //-------------------------------------------------------------------------
+    int64_t solverCalls = 0;
     //-------------------------------------------------------------------------
     NOCModel(Game& g, vec<WinningCondition*>& winConditions, 
-        parity_type playerSAT=EVEN)
-    : g(g), winConditions(winConditions), threshold(threshold), 
-        playerSAT(playerSAT) 
+        const NOCOptions& o=NOCOptions())
+    : g(g), winConditions(winConditions),
+        playerSAT(o.playerSAT), precision(o.precision),
+        parityScc(o.parityScc), weightCycles(o.weightCycles),
+        shortReasons(o.shortReasons), cycleNogoods(o.cycleNogoods),
+        sccMemo(o.sccMemo), amo(o.amo)
     {
         solver = new Solver();
         solver->set("factor",0);
@@ -243,12 +389,25 @@ public:
         for (int i=0; i<g.nedges; i++) {
             solver->add_observed_var(E[i]);
         }
+        for (int i=0; i<T.size(); i++) {
+            solver->add_observed_var(T[i]);
+        }
     }
     //-------------------------------------------------------------------------
     void setupConstraints() {
         for (int i=0; i<g.nvertices;  i++) V[i] = newBoolVar();
         for (int i=0; i<g.nedges;     i++) E[i] = newBoolVar();
 
+        // One guard literal per bisection step, numbered right after the
+        // edges so the propagator's assignment table covers them. Levels are
+        // added by the steps.
+        if (precision > 0 && playerSAT == EVEN) {
+            decimalFraction(precision, stepNum, stepDen);
+            std::pair<int64_t,int64_t> range = levelRange();
+            int steps = std::ceil(std::log2(range.second - range.first));
+            for (int k=0; k<steps; k++) T.push(newBoolVar());
+        }
+
         solver->clause(V[g.init]);
         // --------------------------------------------------------------------
         // For every active PLAYER vertex, one outgoing edge must be activated
@@ -269,7 +428,16 @@ public:
             }
             
             // --- At most one ------------------------------------------------
-            if (n == 1) continue;
+            if (n == 1 || amo == AMO_NATIVE) continue;
+
+            if (amo == AMO_PRODUCT) {
+                std::vector<BoolSAT> x;
+                for (int i=0; i<n; i++) x.push_back(E[g.outs[v][i]]);
+                productAMO(x, [&]() { return newBoolVar(); },
+                    [&](int a, int b) { solver->clause( -a,  b ); },
+                    [&](int a, int b) { solver->clause( -a, -b ); });
+                continue;
+            }
 
             vec<BoolSAT> s(n-1);
             for (int j = 0; j < n-1; j++) s[j] = newBoolVar();
@@ -314,7 +482,13 @@ public:
         // --------------------------------------------------------------------
         // Every infinite OPPONENT play must be avoided regarding codition.
 
-        NOCPropagator *noc = new NOCPropagator(g,V,E,playerSAT,winConditions);
+        vec<WinningCondition*> pathConditions;
+        CycleChecks* cycles = CycleChecks::create(g, winConditions, 
+                                    playerSAT, parityScc, weightCycles,
+                                    pathConditions);
+        noc = new NOCPropagator(g,V,E,playerSAT,pathConditions,T,levels,
+                                stepDen,cycles,shortReasons,cycleNogoods,sccMemo,
+                                amo == AMO_NATIVE);
         solver->connect_external_propagator(noc);
     }
     //-------------------------------------------------------------------------
@@ -332,11 +506,72 @@ public:
         }
     }
     //-------------------------------------------------------------------------
+    // Thresholds j*stepNum/stepDen, from the last j at or below the smallest
+    // weight to the first above the largest.
+    std::pair<int64_t,int64_t> levelRange() const {
+        int64_t lo = 0, hi = 0;
+        for (int e=0; e<g.nedges; e++) {
+            if (e == 0 || g.weights[e] < lo) lo = g.weights[e];
+            if (e == 0 || g.weights[e] > hi) hi = g.weights[e];
+        }
+        auto floorStep = [&](int64_t w) {
+            int64_t j = w*stepDen/stepNum;
+            return j*stepNum > w*stepDen ? j-1 : j;
+        };
+        return { floorStep(lo), floorStep(hi)+1 };
+    }
+    //-------------------------------------------------------------------------
+    // Bisection on the mean-payoff threshold, step k under the assumption
+    // T[k]. CaDiCaL keeps its learnt clauses between solve() calls.
+    bool searchMeanPayoff(double& value) {
+        solverCalls++;
+        if (solver->solve() != 10) return false;
+        keepWitness();
+
+        int64_t lo = levelRange().first;
+        int64_t hi = levelRange().second;
+        for (int k=0; k<T.size() && hi-lo > 1; k++) {
+            int64_t mid = lo + (hi-lo)/2;
+            levels.push(mid*stepNum);
+            for (int j=0; j<k; j++) {       // stronger -> weaker threshold
+                if (levels[k] > levels[j]) solver->clause( -T[k], T[j] );
+                else                       solver->clause( -T[j], T[k] );
+            }
+
+            solver->assume(T[k]);
+            int res = solver->solve();
+            solverCalls++;
+
+            if (res == 10) {
+                lo = mid;
+                keepWitness();
+            }
+            else if (res == 20) {
+                hi = mid;
+                solver->clause( -T[k] );
+            }
+            else break;
+        }
+        value = static_cast<double>(lo*stepNum) / stepDen;
+        return true;
+    }
+    //-------------------------------------------------------------------------
+    void keepWitness() {
+        std::streambuf* old_buf = std::cout.rdbuf();
+        std::stringstream ss;
+        std::cout.rdbuf(ss.rdbuf());
+        print();
+        std::cout.rdbuf(old_buf);
+        witness = ss.str();
+    }
+    //-------------------------------------------------------------------------
+    const std::string& getWitness() const { return witness; }
+    //-------------------------------------------------------------------------
     void print() {
         std::cout << "V=[";
         bool first = true;
         for (int i=0; i<V.size(); i++) {
-            if (solver->val(V[i]) == 1) {
+            if (solver->val(V[i]) > 0) {
                 if (first) first=false; else std::cout << ",";
                 std::cout << i;
             }
@@ -344,7 +579,7 @@ public:
         std::cout << "]\nE=[";
         first = true;
         for (int i=0; i<E.size(); i++) {
-            if (solver->val(E[i]) == 1) {
+            if (solver->val(E[i]) > 0) {
                 if (first) first=false; else std::cout << ",";
                 std::cout << i;
             }
@@ -354,6 +589,26 @@ public:
     //-------------------------------------------------------------------------
     void statistics() {
         solver->statistics();
+        std::cout << "c NOC model: " << pool << " variables, "
+                  << solver->irredundant() << " clauses" << std::endl;
+        if (amo == AMO_NATIVE) {
+            std::cout << "c NOC at-most-one cuts: " << noc->amoCuts
+                      << std::endl;
+        }
+        double avg = noc->explanations
+            ? static_cast<double>(noc->reasonLits)/noc->explanations : 0;
+        std::cout << "c NOC explanations: " << noc->explanations
+                  << " (average length " << avg << ")" << std::endl;
+        if (noc->nogoods) {
+            std::cout << "c NOC nogoods: " << noc->nogoods->stored
+                      << std::endl;
+        }
+        const NOCKernel<NOCPropagator>& kernel = noc->getKernel();
+        if (kernel.hasMemo()) {
+            std::cout << "c NOC memo: " << kernel.pruned << " of "
+                      << kernel.entries + kernel.pruned
+                      << " component entries pruned" << std::endl;
+        }
     }
 };
 
@@ -20,11 +20,43 @@
 #include "chuffed/vars/modelling.h"
 #include "chuffed/core/propagator.h"
 #include "initializer_list"
+#include "sstream"
+#include "cmath"
 
-#ifndef WINNING_CONDITIONS_H
-#include "winning_conditions.h"
+#ifndef NOC_OPTIONS_H
+#include "noc_options.h"
 #endif
 
+#ifndef CONDITION_SET_H
+#include "condition_set.h"
+#endif
+
+#ifndef CYCLE_CHECKS_H
+#include "cycle_checks.h"
+#endif
+
+#ifndef NOC_KERNEL_H
+#include "noc_kernel.h"
+#endif
+
+#ifndef CYCLE_NOGOODS_H
+#include "cycle_nogoods.h"
+#endif
+
+#ifndef AMO_H
+#include "amo.h"
+#endif
+
+#ifndef MP_BOUND_H
+#include "mp_bound.h"
+#endif
+
+#ifndef WARM_START_H
+#include "warm_start.h"
+#endif
+
+#include "chuffed/branching/warm-start.h"
+
 namespace ChuffedBool {
 
 //=============================================================================
@@ -35,119 +67,227 @@ private:
     vec<BoolView> V;
     vec<BoolView> E;
     parity_type playerSAT;
-    vec<WinningCondition*> winConditions;
+    ConditionSet conds;
+    vec<BoolView> T;                    // T[k]: mean >= levels[k]/levelDen
+    vec<int64_t>& levels;
+    int64_t levelDen;
+
+    // Changes since the last propagate(). Only edges fixed to true can open
+    // new paths; a new threshold re-checks every cycle.
+    vec<int32_t> changed;
+    vec<char> isNew;
+    bool full = true;
+
+    // Edges fixed to true into each vertex: the first nTrueIn[w] entries of
+    // trueIn[w], restored by the trail on backtracking.
+    vec<vec<int32_t>> trueIn;
+    vec<Tint> nTrueIn;
+
+    vec<int32_t> reach;                 // reach[v]==stamp: v leads to a new edge
+    int32_t stamp = 0;
 
-    const int   CF_STAY     = 1;
-    const int   CF_CONFLICT = 2;
-    const int   CF_DONE     = 3;
+    CycleChecks* cycles;                // polynomial cycle checks, or nullptr
+    std::vector<int8_t> edgeState;
+    std::vector<CycleCheck::Cut> cuts;
+
+    NOCKernel<NOCPropagator> kernel;
+    PathState& path;
+    friend class NOCKernel<NOCPropagator>;
 
 public:
+    CycleNogoods* nogoods;              // bad cycles seen so far, or nullptr
+    int64_t explanations = 0;
+    int64_t reasonLits = 0;
 
     NOCPropagator(Game& g, vec<BoolView>& V, vec<BoolView>& E, 
-        parity_type playerSAT, vec<WinningCondition*> winConditions)
-    : g(g), V(V), E(E), playerSAT(playerSAT), winConditions(winConditions)
+        parity_type playerSAT, vec<WinningCondition*> winConditions,
+        vec<BoolView>& T, vec<int64_t>& levels, int64_t levelDen,
+        CycleChecks* cycles=nullptr, bool shortReasons=false,
+        bool cycleNogoods=false, bool sccMemo=false)
+    : g(g), V(V), E(E), playerSAT(playerSAT), conds(winConditions,playerSAT),
+        T(T), levels(levels), levelDen(levelDen), cycles(cycles),
+        edgeState(g.nedges),
+        kernel(g,shortReasons,sccMemo), path(kernel.path),
+        nogoods(cycleNogoods ? new CycleNogoods(g) : nullptr)
     {
-        for (size_t i=0; i<g.nvertices;i++) V[i].attach(this, 1 , EVENT_F );
-        for (size_t i=0; i<g.nedges;   i++) E[i].attach(this, 1 , EVENT_F );
+        // Vertex literals take no part in the check and are not watched.
+        for (size_t i=0; i<g.nedges;   i++) E[i].attach(this, i , EVENT_F );
+        for (size_t i=0; i<T.size();   i++) T[i].attach(this, g.nedges+i,
+                                                            EVENT_F );
+        isNew.growTo(g.nedges, 0);
+        reach.growTo(g.nvertices, 0);
+        trueIn.growTo(g.nvertices);
+        for (size_t i=0; i<g.nvertices; i++) {
+            trueIn[i].growTo(g.ins[i].size());
+            nTrueIn.push(Tint(0));
+        }
     }
 
+    ~NOCPropagator() override {
+        delete cycles;
+        delete nogoods;
+    }
+
+    const NOCKernel<NOCPropagator>& getKernel() const { return kernel; }
+
     //-------------------------------------------------------------------------
-    
-    int32_t findVertex(int32_t vertex,vec<int32_t>& path) {
-        for (size_t i=0; i<path.size(); i++) {
-            if (path[i] == vertex) return i;
+    // Marks every vertex with a path of true edges to the source of an edge
+    // fixed since the last call. Paths from init avoiding those vertices were
+    // all checked before.
+
+    void markReach() {
+        stamp++;
+        vec<int32_t> queue;
+        for (size_t i=0; i<changed.size(); i++) {
+            int32_t u = g.sources[changed[i]];
+            if (reach[u] != stamp) { reach[u] = stamp; queue.push(u); }
+        }
+        for (size_t q=0; q<queue.size(); q++) {
+            int32_t w = queue[q];
+            for (int32_t j=0; j<nTrueIn[w]; j++) {
+                int32_t u = g.sources[trueIn[w][j]];
+                if (reach[u] != stamp) { reach[u] = stamp; queue.push(u); }
+            }
         }
-        return -1;
     }
-    
+
     //-------------------------------------------------------------------------
-    
-    void clausify(vec<int32_t>& path, vec<BoolView> &B, vec<Lit>& lits) {
-        for (size_t i=0; i<path.size()-1; i++) {
-            lits.push(B[path[i]].getValLit());
+    // Adapter for the kernel.
+
+    bool isTrueEdge(int32_t e)  { return E[e].isTrue(); }
+    bool isFalseEdge(int32_t e) { return E[e].isFalse(); }
+    bool isNewEdge(int32_t e)   { return isNew[e]; }
+    bool leadsToNew(int32_t v)  { return reach[v] == stamp; }
+    bool isRootEdge(int32_t e)  {
+        return sat.isRootLevel(var(E[e].getValLit()));
+    }
+
+    //-------------------------------------------------------------------------
+    // Weakest asserted threshold the cycle mean falls below (-1 if none). Only
+    // that literal enters the reason, so the learnt clause holds for it and,
+    // through the ladder implications, for every stronger threshold. A guard
+    // means nothing until its step gives it a level, so later ones are
+    // skipped: a cut under them would be learnt against the wrong threshold.
+
+    int32_t violatedLevel(int32_t index) {
+        if (levels.size() == 0) return -1;
+        // mean < levels[k]/levelDen, without dividing
+        __int128 weight = (__int128)levelDen*path.cycleWeight(index);
+        int64_t length = path.cycleLength(index);
+
+        int32_t best = -1;
+        for (size_t k=0; k<levels.size(); k++) {
+            if (!T[k].isTrue() || (__int128)levels[k]*length <= weight) continue;
+            if (best < 0 || levels[k] < levels[best]) best = k;
         }
+        return best;
     }
-    
+
     //-------------------------------------------------------------------------
     
-    bool satisfiedConditions(   vec<int32_t>& pathV, vec<int32_t>& pathE,
-                                vec<int64_t>& pathW, int32_t index) 
-    {
-        if (playerSAT==EVEN) {
-            for (size_t i=0; i<winConditions.size(); i++) {
-                if (!winConditions[i]->satisfy(pathV,pathE,pathW,index)) {
-                    return false;
-                }
-            }
-            return true;
+    // The last edge of the path closes a cycle from 'index'; cut it when the
+    // cycle is bad or falls below an asserted threshold.
+
+    noc_status closeCycle(int32_t index, bool bad) {
+        int32_t level = -1;
+        if (!bad && (level = violatedLevel(index)) < 0) return NOC_STAY;
+
+        if (bad && nogoods) {
+            nogoods->add(path.E, index, [&](int32_t e) {
+                return sat.trailpos[var(E[e].getValLit())];
+            });
         }
-        else {
-            for (size_t i=0; i<winConditions.size(); i++) {
-                if (winConditions[i]->satisfy(pathV,pathE,pathW,index)) {
-                    return true;
-                }
+
+        vec<Lit> lits;
+        lits.push();
+        kernel.explain(*this, index, [&](int32_t e) {
+            lits.push(E[e].getValLit());
+        });
+        if (level >= 0) lits.push(T[level].getValLit());
+        explanations++;
+        reasonLits += lits.size()-1;
+        Clause* reason = Reason_new(lits);
+        return E[path.E.last()].setVal(false,reason) ? NOC_STAY : NOC_CONFLICT;
+    }
+
+    //-------------------------------------------------------------------------
+    // Stored nogoods watching the edges fixed since the last call.
+
+    bool fireNogoods() {
+        auto cut = [&](int32_t id, int32_t f) {
+            vec<Lit> lits;
+            lits.push();
+            for (int32_t e : nogoods->edges(id)) {
+                if (e != f) lits.push(E[e].getValLit());
             }
-            return false;
+            Clause* reason = Reason_new(lits);
+            return E[f].setVal(false,reason);
+        };
+        for (size_t i=0; i<changed.size(); i++) {
+            int32_t e = changed[i];
+            if (!E[e].isTrue()) continue;
+            if (!nogoods->onTrue(e, [&](int32_t x) { return E[x].isTrue(); },
+                                    [&](int32_t x) { return E[x].isFalse(); },
+                                    cut)) return false;
         }
+        return true;
     }
 
     //-------------------------------------------------------------------------
     
-    int filter(vec<int32_t>& pathV, vec<int32_t>& pathE, vec<int64_t>& pathW,
-        int32_t v, int32_t lastEdge, bool definedEdge) 
-    {
-        int32_t index = findVertex(v,pathV);
-        if (index >= 0) {
-
-            if (!satisfiedConditions(pathV,pathE,pathW,index)) {
-                vec<Lit> lits;
-                lits.push();
-                clausify(pathE,E,lits);
-                Clause* reason = Reason_new(lits);
-                if (! E[lastEdge].setVal(false,reason)) {
-                    return CF_CONFLICT;
-                }
-            }
+    bool cutBadCycles() {
+        for (int32_t e=0; e<g.nedges; e++) {
+            edgeState[e] = E[e].isTrue() ? 1 : E[e].isFalse() ? -1 : 0;
         }
-        else if (definedEdge) {
-            pathV.push(v);
-            for (size_t i=0; i<g.outs[v].size(); i++) {
-                int32_t e = g.outs[v][i];
-                if (E[e].isFalse()) continue;
-
-                int w = g.targets[e];
-                int64_t acum = pathW.size() ? g.weights[e]+pathW.last()
-                                            : g.weights[e];
-                pathE.push(e);
-                pathW.push(acum);
-                int status = filter(pathV, pathE, pathW, w, e, E[e].isTrue());
-                pathW.pop();
-                pathE.pop();
-                if (status == CF_CONFLICT) {
-                    return status;
-                }
-            }
-            pathV.pop();
+        cuts.clear();
+        cycles->check(edgeState, cuts);
+        for (size_t i=0; i<cuts.size(); i++) {
+            vec<Lit> lits;
+            lits.push();
+            kernel.explain(*this, cuts[i], [&](int32_t e) {
+                lits.push(E[e].getValLit());
+            });
+            explanations++;
+            reasonLits += lits.size()-1;
+            Clause* reason = Reason_new(lits);
+            if (! E[cuts[i].edge].setVal(false,reason)) return false;
         }
-        return CF_STAY;
+        return true;
     }
 
     //-------------------------------------------------------------------------
     
     bool propagate() override {
-        vec<int32_t> pathV;
-        vec<int32_t> pathE;
-        vec<int64_t> pathW;
-
-        if (filter(pathV,pathE,pathW,g.init,-1,true) == CF_CONFLICT)
+        kernel.reset();
+        if (nogoods && !fireNogoods()) return false;
+        if (cycles && (full || changed.size()) && !cutBadCycles()) {
             return false;
+        }
+        // Every condition is left to the cycle checks or the model.
+        if (conds.size() == 0 && T.size() == 0) return true;
 
-        return true;
+        if (!full) markReach();
+        if (sat.decisionLevel() == 0) kernel.components(*this);
+        noc_status res = conds.visit([&](const auto& satisfy) {
+            return kernel.filter(*this, satisfy, full);
+        });
+        return res != NOC_CONFLICT;
     }
 
     //-------------------------------------------------------------------------
     
     void wakeup(int i, int) override {
+        if (i >= g.nedges) {
+            if (!T[i-g.nedges].isTrue()) return;
+            full = true;
+        }
+        else {
+            if (!E[i].isTrue()) return;
+            int32_t w = g.targets[i];
+            trueIn[w][nTrueIn[w]] = i;
+            nTrueIn[w]++;
+            if (!isNew[i]) { isNew[i] = 1; changed.push(i); }
+        }
         pushInQueue();
     }
     
@@ -155,10 +295,242 @@ public:
     
     void clearPropState() override {
         in_queue = false;
+        for (size_t i=0; i<changed.size(); i++) isNew[changed[i]] = 0;
+        changed.clear();
+        full = false;
     }
 };
 
 //=============================================================================
+// At most one out-edge per PLAYER vertex, without auxiliary variables. An
+// edge fixed to true fixes its siblings to false, each explained by that
+// edge alone.
+
+class AMOPropagator : public Propagator {
+private:
+    Game& g;
+    vec<BoolView> E;
+    vec<int32_t> fixed;                 // edges fixed to true since last call
+public:
+    int64_t cuts = 0;
+
+    AMOPropagator(Game& g, vec<BoolView>& E, parity_type playerSAT)
+    : g(g), E(E)
+    {
+        for (int32_t e=0; e<g.nedges; e++) {
+            int32_t v = g.sources[e];
+            if (g.owners[v] == playerSAT && g.outs[v].size() > 1) {
+                E[e].attach(this, e, EVENT_F);
+            }
+        }
+    }
+
+    //-------------------------------------------------------------------------
+
+    void wakeup(int i, int) override {
+        if (!E[i].isTrue()) return;
+        fixed.push(i);
+        pushInQueue();
+    }
+
+    //-------------------------------------------------------------------------
+
+    bool propagate() override {
+        for (size_t i=0; i<fixed.size(); i++) {
+            int32_t e = fixed[i];
+            int32_t v = g.sources[e];
+            for (size_t j=0; j<g.outs[v].size(); j++) {
+                int32_t f = g.outs[v][j];
+                if (f == e || !E[f].setValNotR(false)) continue;
+                cuts++;
+                if (!E[f].setVal(false, Reason(E[e].getValLit()))) {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+
+    //-------------------------------------------------------------------------
+
+    void clearPropState() override {
+        in_queue = false;
+        fixed.clear();
+    }
+};
+
+//=============================================================================
+// Mean-payoff bounds on the residual game. Woken by PLAYER edges fixed to
+// false, and queued last, so it runs once the cheaper propagators are done
+// and only every 'period'-th time, except at the root: a game lost there is
+// lost for good, and the check makes sure no later reason is made of root
+// literals alone. A lost game fails the initial vertex, explained by the
+// false edges the bound lists. The trail undoes 'stamp' on
+// backtracking, so a check starts from the last measure only while no edge
+// false at the last check has been restored.
+
+class MPBoundPropagator : public Propagator {
+private:
+    Game& g;
+    vec<BoolView> V;
+    vec<BoolView> E;
+    std::vector<MeanPayoffBound*> bounds;
+    int32_t period;
+    int64_t calls = 0;
+    Tint stamp;                         // last check on this branch
+    int32_t checks = 0;
+public:
+
+    MPBoundPropagator(Game& g, vec<BoolView>& V, vec<BoolView>& E,
+        std::vector<MeanPayoffBound*> bounds, int32_t period)
+    : g(g), V(V), E(E), bounds(bounds), period(period), stamp(0)
+    {
+        priority = engine.num_queues-1;
+        for (int32_t e=0; e<g.nedges; e++) {
+            if (g.owners[g.sources[e]] == EVEN) E[e].attach(this, e, EVENT_F);
+        }
+        pushInQueue();
+    }
+
+    ~MPBoundPropagator() override {
+        for (MeanPayoffBound* b : bounds) delete b;
+    }
+
+    const std::vector<MeanPayoffBound*>& getBounds() const { return bounds; }
+
+    //-------------------------------------------------------------------------
+
+    void wakeup(int i, int) override {
+        if (E[i].isFalse()) pushInQueue();
+    }
+
+    //-------------------------------------------------------------------------
+
+    bool propagate() override {
+        if (sat.decisionLevel() > 0 && ++calls % period != 0) return true;
+        bool warm = checks > 0 && stamp == checks;
+        stamp = ++checks;
+        for (MeanPayoffBound* b : bounds) {
+            auto isFalse = [&](int32_t e) { return E[e].isFalse(); };
+            if (b->check(isFalse, warm)) continue;
+            vec<Lit> lits;
+            lits.push();
+            b->explain([&](int32_t e) { lits.push(E[e].getValLit()); });
+            Clause* reason = Reason_new(lits);
+            return V[g.init].setVal(false, reason);
+        }
+        return true;
+    }
+
+    //-------------------------------------------------------------------------
+
+    void clearPropState() override {
+        in_queue = false;
+    }
+};
+
+//=============================================================================
+// PLAYER vertices reached by the strategy, for the brancher: woken when their
+// literal turns true and when one of their edges is chosen, and never queued.
+// Every write goes through the trail, so backtracking restores the list as it
+// was at that level. A vertex that has chosen stays listed until the
+// brancher meets it. With 'reopen' it also logs the sources of the PLAYER
+// edges it sees fixed, and hands them back in 'reopened' once backtracking
+// has unfixed the edge, along with every vertex it reaches.
+
+class NOCFrontier : public Propagator {
+private:
+    Game& g;
+    vec<BoolView> V;
+    vec<BoolView> E;
+    parity_type playerSAT;
+    vec<int32_t> list;                  // the first 'size' entries are live
+    vec<Tint> chosen;                   // chosen[v]: an out-edge of v is true
+    bool reopen;
+    vec<int32_t> fixed;                 // sources of the edges fixed above
+    vec<int> fixedAt;                   // ... the root, and their levels
+public:
+    Tint size;
+    vec<int32_t> reopened;              // for the brancher to take
+
+    NOCFrontier(Game& g, vec<BoolView>& V, vec<BoolView>& E,
+        parity_type playerSAT, bool reopen=false)
+    : g(g), V(V), E(E), playerSAT(playerSAT), reopen(reopen), size(0)
+    {
+        list.growTo(g.nvertices, 0);
+        for (size_t v=0; v<g.nvertices; v++) chosen.push(Tint(0));
+        for (int32_t v=0; v<g.nvertices; v++) {
+            if (g.owners[v] != playerSAT) continue;
+            V[v].attach(this, v, EVENT_F);
+            if (V[v].isTrue()) push(v);
+            if (V[v].isTrue() && reopen) reopened.push(v);
+        }
+        for (int32_t e=0; e<g.nedges; e++) {
+            int32_t v = g.sources[e];
+            if (g.owners[v] != playerSAT) continue;
+            E[e].attach(this, g.nvertices+e, EVENT_F);
+            if (E[e].isTrue()) chosen[v] = 1;
+        }
+    }
+
+    //-------------------------------------------------------------------------
+
+    bool isChosen(int32_t v) const { return chosen[v]; }
+    int32_t at(int32_t i) const { return list[i]; }
+
+    void push(int32_t v) {
+        trailChange(list[size], v);
+        size++;
+    }
+
+    // Drops the entry at 'i', moving the last one into its place.
+    void drop(int32_t i) {
+        trailChange(list[i], list[size-1]);
+        size--;
+    }
+
+    // Moves the logged edges that backtracking unfixed to 'reopened'. Fixes
+    // are logged in order, so they are the ones above the current level.
+    void flush() {
+        int level = engine.decisionLevel();
+        while (fixed.size() > 0 && fixedAt.last() > level) {
+            reopened.push(fixed.last());
+            fixed.pop();
+            fixedAt.pop();
+        }
+    }
+
+    //-------------------------------------------------------------------------
+
+    void wakeup(int i, int) override {
+        if (reopen) flush();
+        if (i < g.nvertices) {
+            if (V[i].isTrue()) push(i);
+            if (V[i].isTrue() && reopen) reopened.push(i);
+            return;
+        }
+        int32_t e = i-g.nvertices;
+        int32_t v = g.sources[e];
+        if (E[e].isTrue() && !chosen[v]) chosen[v] = 1;
+        if (reopen && engine.decisionLevel() > 0) {
+            fixed.push(v);
+            fixedAt.push(engine.decisionLevel());
+        }
+    }
+
+    bool propagate() override { return true; }
+};
+
+//=============================================================================
+// Decides the PLAYER edges, then the 'rest'. BRANCH_SCAN takes the first
+// undecided edge of the first PLAYER vertex whose literal is fixed. The
+// other strategies only branch on reached vertices, from the frontier:
+// BRANCH_DFS the last one reached, which after a choice is its target, and
+// BRANCH_ACTIVITY the one whose undecided edges were bumped most by recent
+// conflicts, from a heap of the reached vertices. Edges are tried in their
+// order, or with 'priorityValues' first towards the priorities that are good
+// for the player, the most dominant first, then towards the bad ones, the
+// least dominant first.
 
 class NOCBrancher : public Branching {
 private:
@@ -166,20 +538,127 @@ private:
     vec<BoolView> V;
     vec<BoolView> E;
     parity_type playerSAT;
+    std::vector<Branching*> rest;       // decided after the edges, in order
+    NOCFrontier* frontier;              // reached PLAYER vertices, or nullptr
+    branch_type strategy;
+    bool priorityValues;
+    vec<vec<int32_t>> order;            // out-edges of each vertex, tried first
+    vec<Tint> next;                     // next[v]: order[v][..next] are fixed
+    Tint open;                          // V and then E below it are fixed
+
+    // BRANCH_ACTIVITY keeps the reached vertices in a heap by the activity
+    // of their open edges. Conflicts only bump fixed edges, so a key can
+    // only grow when backtracking unfixes an edge or reaches the vertex
+    // again, and the frontier reports both. Keys that fell, as edges were
+    // fixed, are refreshed when they reach the top.
+    struct KeyLt {
+        const vec<double>& key;
+        bool operator()(int x, int y) const { return key[x] > key[y]; }
+    };
+    vec<double> key;
+    Heap<KeyLt> heap;
+
+    // The first edge of v in order that is not fixed, or -1.
+    int32_t nextEdge(int32_t v) {
+        vec<int32_t>& es = order[v];
+        int32_t j = next[v];
+        while (j < (int32_t)es.size() && E[es[j]].isFixed()) j++;
+        if (j != next[v]) next[v] = j;
+        return j < (int32_t)es.size() ? es[j] : -1;
+    }
+
+    // Drops the chosen vertices from the top of the frontier, so that the
+    // top is still to choose when it is not empty.
+    void prune() {
+        while (frontier->size > 0 &&
+               frontier->isChosen(frontier->at(frontier->size-1))) {
+            frontier->drop(frontier->size-1);
+        }
+    }
+
+    double activity(int32_t v) {
+        double best = -1;
+        for (size_t j=0; j<g.outs[v].size(); j++) {
+            int32_t e = g.outs[v][j];
+            if (E[e].isFixed()) continue;
+            best = std::max(best, sat.activity[var(E[e].getLit(true))]);
+        }
+        return best;
+    }
+
+    // The reached vertex to branch on, or -1.
+    int32_t select() {
+        if (strategy == BRANCH_DFS) {
+            prune();
+            return frontier->size > 0 ? frontier->at(frontier->size-1) : -1;
+        }
+
+        frontier->flush();
+        vec<int32_t>& reopened = frontier->reopened;
+        for (size_t i=0; i<reopened.size(); i++) {
+            int32_t v = reopened[i];
+            if (!V[v].isTrue() || frontier->isChosen(v)) continue;
+            key[v] = activity(v);
+            heap.update(v);
+        }
+        reopened.clear();
+
+        while (!heap.empty()) {
+            int32_t v = heap[0];
+            if (!V[v].isTrue() || frontier->isChosen(v)) {
+                heap.removeMin();
+                continue;
+            }
+            double a = activity(v);
+            if (a == key[v]) return v;
+            key[v] = a;
+            heap.increase_(v);
+        }
+        return -1;
+    }
+
 public:
     
     NOCBrancher(Game& g, vec<BoolView>& V, vec<BoolView>& E, 
-        parity_type playerSAT) 
-    : g(g), V(V), E(E), playerSAT(playerSAT) {}
+        parity_type playerSAT, std::vector<Branching*> rest={},
+        NOCFrontier* frontier=nullptr, branch_type strategy=BRANCH_SCAN,
+        bool priorityValues=false) 
+    : g(g), V(V), E(E), playerSAT(playerSAT), rest(rest), frontier(frontier),
+        strategy(frontier ? strategy : BRANCH_SCAN),
+        priorityValues(priorityValues), open(0), heap(KeyLt{key})
+    {
+        key.growTo(g.nvertices, 0);
+        order.growTo(g.nvertices);
+        for (int32_t v=0; v<g.nvertices; v++) {
+            next.push(Tint(0));
+            for (size_t j=0; j<g.outs[v].size(); j++) {
+                order[v].push(g.outs[v][j]);
+            }
+            if (!priorityValues) continue;
+            auto rank = [&](int32_t e) {
+                int64_t p = g.priors[g.targets[e]];
+                int64_t q = g.objective == MAX ? p : -p;
+                return p%2 == playerSAT ? std::make_pair(1,q)
+                                        : std::make_pair(0,-q);
+            };
+            std::stable_sort((int32_t*)order[v], (int32_t*)order[v]+order[v].size(),
+                [&](int32_t a, int32_t b) { return rank(a) > rank(b); });
+        }
+    }
 
     //-------------------------------------------------------------------------
     
     bool finished() override {
-        for (size_t i=0; i<V.size(); i++) {
-            if (!V[i].isFixed()) return false;
+        if (strategy == BRANCH_SCAN) {
+            int32_t nv = V.size(), i = open;
+            while (i < nv && V[i].isFixed()) i++;
+            while (i >= nv && i-nv < (int32_t)E.size() && E[i-nv].isFixed()) i++;
+            if (i != open) open = i;
+            if (i < nv+(int32_t)E.size()) return false;
         }
-        for (size_t i=0; i<E.size(); i++) {
-            if (!E[i].isFixed()) return false;
+        else if (select() >= 0) return false;
+        for (Branching* b : rest) {
+            if (!b->finished()) return false;
         }
         return true;
     }
@@ -193,16 +672,24 @@ public:
     //-------------------------------------------------------------------------
 
     DecInfo* branch() override {
-        for (size_t v=0; v<V.size(); v++) {
-            if (g.owners[v]==playerSAT && V[v].isFixed()) {
-                for (size_t j=0; j<g.outs[v].size(); j++) {
-                    int32_t e = g.outs[v][j];
-                    if (!E[e].isFixed()) {
-                        return E[e].branch();
-                    }
+        if (strategy == BRANCH_SCAN) {
+            for (size_t v=0; v<V.size(); v++) {
+                if (g.owners[v]==playerSAT && V[v].isFixed()) {
+                    int32_t e = nextEdge(v);
+                    if (e < 0) continue;
+                    if (!priorityValues) return E[e].branch();
+                    return new DecInfo(nullptr, toInt(E[e].getLit(true)));
                 }
             }
         }
+        else {
+            int32_t v = select();
+            int32_t e = v < 0 ? -1 : nextEdge(v);
+            if (e >= 0) return new DecInfo(nullptr, toInt(E[e].getLit(true)));
+        }
+        for (Branching* b : rest) {
+            if (!b->finished()) return b->branch();
+        }
         return nullptr;
     }
 };
@@ -217,14 +704,48 @@ private:
     vec<WinningCondition*> winConditions;
     int printtype;
     parity_type playerSAT;
+
+    double precision;
+    bool parityScc;
+    bool weightCycles;
+    bool shortReasons;
+    bool cycleNogoods;
+    bool sccMemo;
+    bool aliasEdges;
+    amo_type amo;
+    bool pmModel;
+    int32_t mpBound;                    // period of the mean-payoff bound
+    branch_type strategy;               // order of the PLAYER vertices
+    bool branchPriority;                // edges towards good priorities first
+    warm_type warmStart;                // engine of the first descent
+    int32_t warmEdges = 0;              // ... and the edges it decides
+    vec<vec<IntVar*>> R;                // R[v][j]: rank of v for bad colour j
+    std::vector<Branching*> ranks;
+    NOCPropagator* noc = nullptr;
+    AMOPropagator* amoProp = nullptr;
+    MPBoundPropagator* mpProp = nullptr;
+    vec<BoolView> T;                    // mean-payoff threshold ladder
+    vec<int64_t> levels;                // ... its thresholds times stepDen
+    int64_t stepNum = 1;                // precision as a decimal fraction
+    int64_t stepDen = 1;
+    std::string witness;
+
+    int32_t aliased = 0;                // edges sharing their source literal
+    int32_t droppedClauses = 0;         // ... and the clauses this made void
 public:
+    int64_t solverCalls = 0;
 
     //-------------------------------------------------------------------------
 
     NOCModel(Game& g, vec<WinningCondition*>& winConditions, 
-        int printtype=0, parity_type playerSAT=EVEN) 
-    :g(g), winConditions(winConditions), printtype(printtype), 
-        playerSAT(playerSAT)
+        const NOCOptions& o=NOCOptions()) 
+    :g(g), winConditions(winConditions), printtype(o.printtype), 
+        playerSAT(o.playerSAT), precision(o.precision),
+        parityScc(o.parityScc), weightCycles(o.weightCycles),
+        shortReasons(o.shortReasons), cycleNogoods(o.cycleNogoods),
+        sccMemo(o.sccMemo), aliasEdges(o.aliasEdges), amo(o.amo),
+        pmModel(o.pmModel), mpBound(o.mpBound), strategy(o.branch),
+        branchPriority(o.branchPriority), warmStart(o.warmStart)
     {
         V.growTo(g.nvertices);
         E.growTo(g.nedges);
@@ -233,10 +754,34 @@ public:
 
     //-------------------------------------------------------------------------
 
+    // An OPPONENT edge, or the only edge of a PLAYER vertex, is active when
+    // its source is. Activating it while the source is not only adds a dead
+    // edge, which the propagator never reaches from init, so it can share
+    // the source's literal instead of being tied to it by a clause.
+
+    bool isAlias(int32_t e) const {
+        int32_t v = g.sources[e];
+        return aliasEdges && (g.owners[v] != playerSAT || g.outs[v].size() == 1);
+    }
+
+    //-------------------------------------------------------------------------
+
     void setupConstraints() {
 
         for (size_t i=0; i<g.nvertices;  i++) V[i] = newBoolVar();
-        for (size_t i=0; i<g.nedges;     i++) E[i] = newBoolVar();
+        for (size_t i=0; i<g.nedges;     i++) {
+            if (isAlias(i)) { E[i] = V[g.sources[i]]; aliased++; }
+            else E[i] = newBoolVar();
+        }
+
+        // One guard literal per bisection step, so each threshold is assumed
+        // rather than built into the model. Levels are added by the steps.
+        if (precision > 0 && playerSAT == EVEN) {
+            decimalFraction(precision, stepNum, stepDen);
+            std::pair<int64_t,int64_t> range = levelRange();
+            int32_t steps = std::ceil(std::log2(range.second - range.first));
+            for (int32_t k=0; k<steps; k++) T.push(newBoolVar());
+        }
 
         // Initial vertex
         fixVertices({g.init},{});
@@ -250,7 +795,8 @@ public:
             // --- At least one -----------------------------------------------
             if (n == 0) continue;
 
-            {
+            if (isAlias(g.outs[v][0])) droppedClauses++;
+            else {
                 vec<Lit> clause;
                 clause.push( V[v].getLit(false) );
                 for (size_t i=0; i<g.outs[v].size(); i++) {
@@ -261,7 +807,26 @@ public:
             }
 
             // --- At most one ------------------------------------------------
-            if (n == 1) continue;
+            if (n == 1 || amo == AMO_NATIVE) continue;
+
+            if (amo == AMO_PRODUCT) {
+                std::vector<BoolView> x;
+                for (size_t i=0; i<n; i++) x.push_back(E[g.outs[v][i]]);
+                productAMO(x, []() { return newBoolVar(); },
+                    [](BoolView a, BoolView b) {
+                        vec<Lit> clause;
+                        clause.push(a.getLit(false));
+                        clause.push(b.getLit(true));
+                        sat.addClause(clause);
+                    },
+                    [](BoolView a, BoolView b) {
+                        vec<Lit> clause;
+                        clause.push(a.getLit(false));
+                        clause.push(b.getLit(false));
+                        sat.addClause(clause);
+                    });
+                continue;
+            }
 
             vec<BoolView> s(n - 1);
             for (size_t j = 0; j < n - 1; j++) s[j] = newBoolVar();
@@ -322,6 +887,7 @@ public:
             if (g.owners[v]==opponent(playerSAT)) {
                 for (size_t i=0; i<g.outs[v].size(); i++) {
                     int32_t e = g.outs[v][i];
+                    if (isAlias(e)) { droppedClauses++; continue; }
                     vec<Lit> clause;
                     clause.push( V[v].getLit(false) );        
                     clause.push( E[e].getLit(true) );
@@ -335,6 +901,10 @@ public:
         for (size_t w=0; w<g.nvertices; w++) if (w != g.init) {
             for (size_t i=0; i<g.ins[w].size(); i++) {
                 int32_t e = g.ins[w][i];
+                if (isAlias(e) && g.sources[e] == w) {
+                    droppedClauses++;
+                    continue;
+                }
                 vec<Lit> clause;
                 clause.push( E[e].getLit(false) );
                 clause.push( V[w].getLit(true) );
@@ -344,7 +914,16 @@ public:
 
         // --------------------------------------------------------------------
         // Every infinite OPPONENT play must be avoided regarding codition.
-        new NOCPropagator(g,V,E,playerSAT,winConditions);
+        vec<WinningCondition*> conditions;
+        setupProgressMeasure(conditions);
+        vec<WinningCondition*> pathConditions;
+        CycleChecks* cycles = CycleChecks::create(g, conditions, 
+                                    playerSAT, parityScc, weightCycles,
+                                    pathConditions);
+        noc = new NOCPropagator(g,V,E,playerSAT,pathConditions,T,levels,
+                                stepDen,cycles,shortReasons,cycleNogoods,sccMemo);
+        if (amo == AMO_NATIVE) amoProp = new AMOPropagator(g,E,playerSAT);
+        setupMeanPayoffBounds();
 
         //---------------------------------------------------------------------
 
@@ -355,11 +934,287 @@ public:
         
         // branch(bv, VAR_INORDER, VAL_MIN);
         // branch(be, VAR_INORDER, VAL_MIN);
-        engine.branching->add(new NOCBrancher(g,V,E,playerSAT));
+        // Chuffed only bumps conflict activity when VSIDS is on; switched on
+        // here, after its options, it bumps without joining the branching.
+        NOCFrontier* frontier = nullptr;
+        if (strategy != BRANCH_SCAN) frontier = new NOCFrontier(g,V,E,playerSAT,
+                                                strategy == BRANCH_ACTIVITY);
+        if (strategy == BRANCH_ACTIVITY) so.vsids = true;
+        if (warmStart != WARM_NONE) setupWarmStart();
+        engine.branching->add(new NOCBrancher(g,V,E,playerSAT,ranks,
+                                              frontier,strategy,branchPriority));
         output_vars(bv);
         output_vars(be);
     }
 
+    //-------------------------------------------------------------------------
+    // The first descent follows the strategy of a cheap engine, until the
+    // first conflict. Every PLAYER edge also gets the strategy as its phase,
+    // which the edge brancher and Chuffed's phase saving start from.
+
+    void setupWarmStart() {
+        WarmStart ws(g, warmStart, playerSAT);
+        vec<Lit> decs;
+        for (int32_t e : ws.decisions) decs.push(E[e].getLit(true));
+        for (int32_t e=0; e<g.nedges; e++) {
+            if (g.owners[g.sources[e]] != playerSAT) continue;
+            Lit p = E[e].getLit(ws.chosen(g,e));
+            sat.polarity[var(p)] = sign(p);
+        }
+        warmEdges = decs.size();
+        engine.branching->add(new WarmStartBrancher(decs));
+    }
+
+    //-------------------------------------------------------------------------
+    // Residual-game bounds for the mean-payoff conditions of EVEN, which are
+    // conjunctive with the others. A game whose weights overflow the energy
+    // measure is left to the NOC propagator alone.
+
+    void setupMeanPayoffBounds() {
+        if (mpBound <= 0 || playerSAT != EVEN) return;
+        std::vector<MeanPayoffBound*> bounds;
+        for (size_t i=0; i<winConditions.size(); i++) {
+            auto mp = dynamic_cast<MeanPayoffCondition*>(winConditions[i]);
+            if (!mp) continue;
+            try {
+                bounds.push_back(new MeanPayoffBound(g, *mp));
+            } catch (const std::overflow_error&) {}
+        }
+        if (bounds.size()) {
+            mpProp = new MPBoundPropagator(g,V,E,bounds,mpBound);
+        }
+    }
+
+    //-------------------------------------------------------------------------
+    // Progress-measure encoding of the parity condition, instead of the NOC
+    // propagator. Every vertex ranks each colour bad for playerSAT in
+    // 0..(vertices of that colour). An active edge from a vertex of colour p
+    // needs the ranks of its source, restricted to the bad colours at least
+    // as good as p and best first, to be lexicographically >= those of its
+    // target, and > when p is bad; on a cycle whose best colour is bad they
+    // would drop and never rise. 'rest' gets the other conditions, or all of
+    // them for ODD with several, since ODD's conditions are disjunctive.
+
+    void setupProgressMeasure(vec<WinningCondition*>& rest) {
+        int32_t parity = -1;
+        for (size_t i=0; i<winConditions.size(); i++) {
+            if (dynamic_cast<ParityCondition*>(winConditions[i])) parity = i;
+        }
+        bool split = pmModel && parity >= 0 &&
+                     (playerSAT == EVEN || winConditions.size() == 1);
+        for (size_t i=0; i<winConditions.size(); i++) {
+            if (!split || (int32_t)i != parity) rest.push(winConditions[i]);
+        }
+        if (!split) return;
+
+        std::vector<int64_t> bad;
+        for (int32_t v=0; v<g.nvertices; v++) {
+            if (g.priors[v]%2 != playerSAT) bad.push_back(g.priors[v]);
+        }
+        std::sort(bad.begin(), bad.end(), [&](int64_t a, int64_t b) {
+            return g.isBetter(a,b);
+        });
+        bad.erase(std::unique(bad.begin(), bad.end()), bad.end());
+        std::vector<int32_t> count(bad.size(), 0);
+        for (int32_t v=0; v<g.nvertices; v++) {
+            for (size_t j=0; j<bad.size(); j++) {
+                if (g.priors[v] == bad[j]) count[j]++;
+            }
+        }
+
+        R.growTo(g.nvertices);
+        for (int32_t v=0; v<g.nvertices; v++) {
+            R[v].growTo(bad.size());
+            for (size_t j=0; j<bad.size(); j++) {
+                createVar(R[v][j], 0, count[j]);
+            }
+        }
+        for (size_t j=0; j<bad.size(); j++) {
+            for (int32_t v=0; v<g.nvertices; v++) ranks.push_back(R[v][j]);
+        }
+
+        for (int32_t e=0; e<g.nedges; e++) {
+            int32_t v = g.sources[e];
+            int32_t w = g.targets[e];
+            int64_t p = g.priors[v];
+            bool strict = p%2 != playerSAT;
+            size_t k = 0;
+            while (k < bad.size() && !g.isBetter(p, bad[k])) k++;
+
+            // A bad self-loop cannot be ranked. It is excluded by a
+            // propagator, not a unit clause: a loop already forced at the
+            // root must fail in the search, since Chuffed exits on a
+            // contradiction while the model is set up.
+            if (v == w) {
+                if (strict) {
+                    int_rel_half_reif(R[v][k-1], IRT_GT,
+                                      getConstant(count[k-1]), E[e]);
+                }
+                continue;
+            }
+
+            // eq: the ranks agree on the colours before j
+            BoolView eq = E[e];
+            for (size_t j=0; j<k; j++) {
+                if (j+1 == k) {
+                    int_rel_half_reif(R[v][j], strict ? IRT_GT : IRT_GE,
+                                      R[w][j], eq);
+                    break;
+                }
+                int_rel_half_reif(R[v][j], IRT_GE, R[w][j], eq);
+                BoolView gt = newBoolVar();
+                BoolView next = newBoolVar();
+                int_rel_half_reif(R[v][j], IRT_GT, R[w][j], gt);
+                vec<Lit> clause;
+                clause.push(eq.getLit(false));
+                clause.push(gt.getLit(true));
+                clause.push(next.getLit(true));
+                sat.addClause(clause);
+                eq = next;
+            }
+        }
+    }
+
+    //-------------------------------------------------------------------------
+
+    // Thresholds are multiples of the precision: j*stepNum/stepDen. The
+    // range holds the last j at or below the smallest weight, which EVEN
+    // always ensures, and the first j above the largest, which it never does.
+
+    std::pair<int64_t,int64_t> levelRange() const {
+        int64_t lo = 0, hi = 0;
+        for (int32_t e=0; e<g.nedges; e++) {
+            if (e == 0 || g.weights[e] < lo) lo = g.weights[e];
+            if (e == 0 || g.weights[e] > hi) hi = g.weights[e];
+        }
+        auto floorStep = [&](int64_t w) {
+            int64_t j = w*stepDen/stepNum;
+            return j*stepNum > w*stepDen ? j-1 : j;
+        };
+        return { floorStep(lo), floorStep(hi)+1 };
+    }
+
+    //-------------------------------------------------------------------------
+    // Bisection on the mean-payoff threshold within a single solver. Step k
+    // assumes T[k]; clauses learnt in earlier steps stay, and those depending
+    // on a threshold mention its literal. Returns false when EVEN cannot
+    // satisfy the other conditions at all, otherwise 'value' is a threshold
+    // EVEN ensures and value+precision one it does not.
+
+    bool searchMeanPayoff(double& value) {
+        engine.solve(this);
+        solverCalls++;
+        if (!engine.solutions) return false;
+        keepWitness();
+
+        int64_t lo = levelRange().first;
+        int64_t hi = levelRange().second;
+        for (size_t k=0; k<T.size() && hi-lo > 1; k++) {
+            int64_t mid = lo + (hi-lo)/2;
+            levels.push(mid*stepNum);
+            sat.btToLevel(0);
+            for (size_t j=0; j<k; j++) {
+                vec<Lit> clause;    // stronger threshold -> weaker threshold
+                bool stronger = levels[k] > levels[j];
+                clause.push(T[stronger ? k : j].getLit(false));
+                clause.push(T[stronger ? j : k].getLit(true));
+                sat.addClause(clause);
+            }
+
+            engine.assumptions.clear();
+            engine.assumptions.push(toInt(T[k].getLit(true)));
+            engine.solutions = 0;
+            RESULT res = engine.search();
+            solverCalls++;
+
+            if (res == RES_SAT) {
+                lo = mid;
+                keepWitness();
+            }
+            else if (res == RES_UNK) break;
+            else {
+                hi = mid;
+                sat.btToLevel(0);
+                vec<Lit> unit;
+                unit.push(T[k].getLit(false));
+                sat.addClause(unit);
+            }
+        }
+        engine.assumptions.clear();
+        value = static_cast<double>(lo*stepNum) / stepDen;
+        return true;
+    }
+
+    //-------------------------------------------------------------------------
+    // Enumeration projected onto the PLAYER choices. A strategy is the edges
+    // chosen at the PLAYER vertices with more than one edge that the true
+    // edges reach from init; each one found is blocked by a clause over those
+    // edges alone, so solutions that differ only in unreached vertices,
+    // OPPONENT edges or auxiliaries are not repeated. Strategies are written
+    // to 'out' as they are found. At most 'limit' (0 for all); returns how
+    // many were found.
+
+    int64_t enumerate(int64_t limit, std::ostream& out) {
+        int64_t found = 0;
+        std::vector<char> reached(g.nvertices);
+        std::vector<int32_t> queue;
+        vec<Lit> clause;
+
+        // Read at the solution itself: Chuffed backtracks before returning.
+        engine.setSolutionCallback([&](Problem*) {
+            found++;
+            if (printtype) {
+                print(out);
+                out << "\n----------" << std::endl;
+            }
+            std::fill(reached.begin(), reached.end(), 0);
+            queue.assign(1, g.init);
+            reached[g.init] = 1;
+            clause.clear();
+            for (size_t q=0; q<queue.size(); q++) {
+                int32_t v = queue[q];
+                bool choice = g.owners[v] == playerSAT && g.outs[v].size() > 1;
+                for (size_t j=0; j<g.outs[v].size(); j++) {
+                    int32_t e = g.outs[v][j];
+                    if (!E[e].isTrue()) continue;
+                    if (choice && !sat.isRootLevel(var(E[e].getValLit()))) {
+                        clause.push(E[e].getLit(false));
+                    }
+                    int32_t w = g.targets[e];
+                    if (!reached[w]) { reached[w] = 1; queue.push_back(w); }
+                }
+            }
+        });
+
+        int nof_solutions = so.nof_solutions;
+        so.nof_solutions = 1;
+        engine.solve(this);
+        solverCalls++;
+        while (engine.solutions) {
+            if (limit && found == limit) break;
+            if (clause.size() == 0) break;  // the only strategy there is
+
+            sat.btToLevel(0);
+            sat.addClause(clause);
+            engine.solutions = 0;
+            engine.search();
+            solverCalls++;
+        }
+        so.nof_solutions = nof_solutions;
+        engine.setSolutionCallback(nullptr);
+        return found;
+    }
+
+    //-------------------------------------------------------------------------
+
+    void keepWitness() {
+        std::stringstream ss;
+        print(ss);
+        witness = ss.str();
+    }
+
+    const std::string& getWitness() const { return witness; }
+
     //-------------------------------------------------------------------------
 
     void fixVertices(   std::initializer_list<int32_t> vs,
@@ -417,6 +1272,70 @@ public:
             out << "]";
         }
     }
+
+    //-------------------------------------------------------------------------
+    // Counters of the NOC propagator and of the enabled model options, in
+    // Chuffed's own statistics format.
+
+    void statistics() {
+        int64_t learnt = 0;
+        for (size_t i=0; i<sat.learnts.size(); i++) {
+            learnt += sat.learnts[i]->size();
+        }
+        double avgReason = noc->explanations
+            ? static_cast<double>(noc->reasonLits)/noc->explanations : 0;
+        double avgLearnt = sat.learnts.size()
+            ? static_cast<double>(learnt)/sat.learnts.size() : 0;
+        std::cout << "%%%mzn-stat: nocExplanations=" << noc->explanations
+                  << "\n%%%mzn-stat: nocReasonLength=" << avgReason
+                  << "\n%%%mzn-stat: learntClauses=" << sat.learnts.size()
+                  << "\n%%%mzn-stat: learntLength=" << avgLearnt
+                  << std::endl;
+        if (noc->nogoods) {
+            std::cout << "%%%mzn-stat: nocNogoods=" << noc->nogoods->stored
+                      << "\n%%%mzn-stat: nocNogoodCuts=" << noc->nogoods->fired
+                      << std::endl;
+        }
+        const NOCKernel<NOCPropagator>& kernel = noc->getKernel();
+        if (kernel.hasMemo()) {
+            int64_t visits = kernel.entries + kernel.pruned;
+            std::cout << "%%%mzn-stat: nocMemoEntries=" << visits
+                      << "\n%%%mzn-stat: nocMemoPruned=" << kernel.pruned
+                      << "\n%%%mzn-stat: nocMemoRate="
+                      << (visits ? static_cast<double>(kernel.pruned)/visits : 0)
+                      << std::endl;
+        }
+        std::cout << "%%%mzn-stat: modelVariables=" << sat.nVars()
+                  << "\n%%%mzn-stat: modelClauses="
+                  << sat.bin_clauses + sat.tern_clauses + sat.long_clauses
+                  << std::endl;
+        if (aliasEdges) {
+            std::cout << "%%%mzn-stat: aliasedEdges=" << aliased
+                      << "\n%%%mzn-stat: aliasedClauses=" << droppedClauses
+                      << std::endl;
+        }
+        if (amoProp) {
+            std::cout << "%%%mzn-stat: amoCuts=" << amoProp->cuts << std::endl;
+        }
+        if (pmModel) {
+            std::cout << "%%%mzn-stat: pmRanks=" << ranks.size() << std::endl;
+        }
+        if (mpProp) {
+            int64_t checks = 0, conflicts = 0, lifts = 0;
+            for (MeanPayoffBound* b : mpProp->getBounds()) {
+                checks += b->checks;
+                conflicts += b->conflicts;
+                lifts += b->lifts();
+            }
+            std::cout << "%%%mzn-stat: mpBoundChecks=" << checks
+                      << "\n%%%mzn-stat: mpBoundConflicts=" << conflicts
+                      << "\n%%%mzn-stat: mpBoundLifts=" << lifts
+                      << std::endl;
+        }
+        if (warmStart != WARM_NONE) {
+            std::cout << "%%%mzn-stat: warmStartEdges=" << warmEdges << std::endl;
+        }
+    }
 };
 
 } // namespace ChuffedBool
\ No newline at end of file
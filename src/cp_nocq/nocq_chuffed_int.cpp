@@ -21,10 +21,33 @@
 #include "chuffed/core/propagator.h"
 #include "initializer_list"
 
-#ifndef WINNING_CONDITIONS_H
-#include "winning_conditions.h"
+#ifndef NOC_OPTIONS_H
+#include "noc_options.h"
 #endif
 
+#ifndef CONDITION_SET_H
+#include "condition_set.h"
+#endif
+
+#ifndef CYCLE_CHECKS_H
+#include "cycle_checks.h"
+#endif
+
+#ifndef NOC_KERNEL_H
+#include "noc_kernel.h"
+#endif
+
+#ifndef BLOCK_SYMMETRY_H
+#include "block_symmetry.h"
+#endif
+
+#ifndef WARM_START_H
+#include "warm_start.h"
+#endif
+
+#include "chuffed/ldsb/ldsb.h"
+#include "chuffed/branching/warm-start.h"
+
 namespace ChuffedInt {
 
 //=============================================================================
@@ -34,135 +57,130 @@ private:
     Game& g;
     vec<IntVar*> V;
     parity_type playerSAT;
-    vec<WinningCondition*> winConditions;
+    ConditionSet conds;
 
-    const int CF_STAY     = 1;
-    const int CF_CONFLICT = 2;
-    const int CF_DONE     = 3;
+    CycleChecks* cycles;                // polynomial cycle checks, or nullptr
+    std::vector<int32_t> position;      // index of each edge in its outs[]
+    std::vector<int8_t> edgeState;
+    std::vector<CycleCheck::Cut> cuts;
+
+    NOCKernel<NOCPropagator> kernel;
+    PathState& path;
+    friend class NOCKernel<NOCPropagator>;
 
 public:
     
     NOCPropagator(Game& g, vec<IntVar*>& V, 
-        parity_type playerSAT, vec<WinningCondition*> winConditions)
-    : g(g), V(V), playerSAT(playerSAT), winConditions(winConditions)
+        parity_type playerSAT, vec<WinningCondition*> winConditions,
+        CycleChecks* cycles=nullptr, bool sccMemo=false)
+    : g(g), V(V), playerSAT(playerSAT), conds(winConditions,playerSAT),
+        cycles(cycles), position(g.nedges), edgeState(g.nedges),
+        kernel(g,false,sccMemo), path(kernel.path)
     {
         for (size_t i=0; i<g.nvertices;i++) V[i]->attach(this, 1 , EVENT_F );
-    }
-    
-    //-------------------------------------------------------------------------
-    
-    int32_t findVertex(int vertex,vec<int>& path) {
-        for (size_t i=0; i<path.size(); i++) {
-            if (path[i] == vertex) return i;
+        for (int32_t v=0; v<g.nvertices; v++) {
+            for (size_t i=0; i<g.outs[v].size(); i++) position[g.outs[v][i]] = i;
         }
-        return -1;
+    }
+
+    ~NOCPropagator() override {
+        delete cycles;
     }
     
     //-------------------------------------------------------------------------
-    
-    void clausify(vec<int32_t>& path, vec<BoolView> &B, vec<Lit>& lits) {
-        for (size_t i=0; i<path.size()-1; i++) {
-            lits.push(B[path[i]].getValLit());
-        }
+    // Adapter for the kernel. An edge is committed when its source picked it
+    // and its target is active, and excluded when either rules it out. All
+    // cycles are checked on every call.
+
+    bool isTrueEdge(int32_t e) {
+        IntVar* w = V[g.targets[e]];
+        return edgeStatus(e) == 1 && w->isFixed() && w->getVal() >= 0;
     }
-    
+    bool isFalseEdge(int32_t e) {
+        IntVar* w = V[g.targets[e]];
+        return edgeStatus(e) == -1 || (w->isFixed() && w->getVal() < 0);
+    }
+    bool isNewEdge(int32_t e)   { return false; }
+    bool leadsToNew(int32_t v)  { return true; }
+    bool isRootEdge(int32_t e)  { return false; }
+
     //-------------------------------------------------------------------------
-    
-    bool satisfiedConditions(   vec<int32_t>& pathV, vec<int32_t>& pathE,
-                                vec<int64_t>& pathW, int32_t index) 
-    {
-        if (playerSAT==EVEN) {
-            for (size_t i=0; i<winConditions.size(); i++) {
-                if (!winConditions[i]->satisfy(pathV,pathE,pathW,index)) {
-                    return false;
-                }
-            }
-            return true;
+    // The last edge of the path closes a cycle from 'index'. A bad cycle
+    // removes that option of its source, or deactivates an opponent source,
+    // which ends this propagation. The reason is the path to the source.
+
+    noc_status closeCycle(int32_t index, bool bad) {
+        if (!bad) return NOC_STAY;
+
+        int32_t e = path.E.last();
+        int32_t last = g.sources[e];
+        Clause* r = Reason_new(path.V.size());
+        for (size_t i=0; i<path.V.size()-1; i++) {
+            int32_t v_ = path.V[i];
+            (*r)[i+1] = V[v_]->getValLit();
         }
-        else {
-            for (size_t i=0; i<winConditions.size(); i++) {
-                if (winConditions[i]->satisfy(pathV,pathE,pathW,index)) {
-                    return true;
-                }
-            }
-            return false;
+        if (g.owners[last]==playerSAT) {
+            if (!V[last]->remVal(position[e],r)) return NOC_CONFLICT;
+            return NOC_STAY;
+        } else {
+            if (!V[last]->setVal( -1,r)) return NOC_CONFLICT;
+            return NOC_DONE;
         }
     }
-    
+
     //-------------------------------------------------------------------------
     
-    int filter(vec<int32_t>& pathV, vec<int32_t>& pathE, vec<int64_t>& pathW,
-        int32_t v, int32_t last, int32_t out, bool isFixed) 
-    {
-        int index = findVertex(v,pathV);
-        if (index >= 0) {
-            if (!satisfiedConditions(pathV,pathE,pathW,index)) {
-                Clause* r = Reason_new(pathV.size());
-                for (size_t i=0; i<pathV.size()-1; i++) {
-                    int32_t v_ = pathV[i];
-                    (*r)[i+1] = V[v_]->getValLit();
-                }
-                if (g.owners[last]==playerSAT) {
-                    if (!V[last]->remVal(out,r)) return CF_CONFLICT;
-                    return CF_STAY;
-                } else {
-                    if (!V[last]->setVal( -1,r)) return CF_CONFLICT;
-                    return CF_DONE;
-                }
+    // An edge of a playerSAT vertex is true when the vertex picked it; the
+    // edges of an opponent vertex are true once the vertex is active.
+
+    int8_t edgeStatus(int32_t e) {
+        IntVar* x = V[g.sources[e]];
+        int32_t i = g.owners[g.sources[e]]==playerSAT ? position[e] : 0;
+        if (x->isFixed()) return x->getVal() == i ? 1 : -1;
+        return x->indomain(i) ? 0 : -1;
+    }
+
+    //-------------------------------------------------------------------------
+
+    bool cutBadCycles() {
+        for (int32_t e=0; e<g.nedges; e++) edgeState[e] = edgeStatus(e);
+        cuts.clear();
+        cycles->check(edgeState, cuts);
+        for (size_t i=0; i<cuts.size(); i++) {
+            std::vector<int32_t> vs;    // one literal per deciding vertex
+            for (int32_t e : cuts[i].reason) vs.push_back(g.sources[e]);
+            std::sort(vs.begin(), vs.end());
+            vs.erase(std::unique(vs.begin(), vs.end()), vs.end());
+            Clause* r = Reason_new(vs.size()+1);
+            for (size_t j=0; j<vs.size(); j++) {
+                (*r)[j+1] = V[vs[j]]->getValLit();
             }
-        }
-        else if (isFixed) {
-            pathV.push(v);
-            if (g.owners[v]==playerSAT) {
-                int i = V[v]->getVal();
-                int32_t e = g.outs[v][i];
-                int32_t w = g.targets[e];
-                if (!V[w]->isFixed() || V[w]->getVal()>=0) {
-                    int64_t acum = pathW.size() ? g.weights[e]+pathW.last()
-                                                : g.weights[e];
-                    pathE.push(e);
-                    pathW.push(acum);
-                    int status = filter(pathV, pathE, pathW,  w, v, i, 
-                                        V[w]->isFixed());
-                    pathW.pop();
-                    pathE.pop();
-                    if (status != CF_STAY) return status;
-                }
+            int32_t e = cuts[i].edge;
+            int32_t u = g.sources[e];
+            if (g.owners[u]==playerSAT) {
+                if (!V[u]->remVal(position[e],r)) return false;
             } else {
-                for (int i=0; i<g.outs[v].size(); i++) {
-                    int32_t e = g.outs[v][i];
-                    int32_t w = g.targets[e];
-                    if (!V[w]->isFixed() || V[w]->getVal()>=0) {
-                        int64_t acum = pathW.size() ? g.weights[e]+pathW.last()
-                                                    : g.weights[e];
-                        pathE.push(e);
-                        pathW.push(acum);
-                        int status = filter(pathV, pathE, pathW, w, v, i, 
-                                            V[w]->isFixed());
-                        pathW.pop();
-                        pathE.pop();
-                        if (status != CF_STAY) return status;
-                    }
-                }
+                if (!V[u]->setVal(-1,r)) return false;
             }
-            pathV.pop();
         }
-        return CF_STAY;
+        return true;
     }
-    
+
     //-------------------------------------------------------------------------
     
     bool propagate() override {
-        vec<int32_t> pathV;
-        vec<int32_t> pathO;
-        vec<int64_t> pathW;
-
         if (!V[g.init]->isFixed()) return true;
 
-        if (filter(pathV,pathO,pathW,g.init,-1,-1,true) == CF_CONFLICT)
-            return false;
+        if (cycles) {
+            if (!cutBadCycles()) return false;
+            if (conds.size() == 0) return true;
+        }
 
-        return true;
+        if (sat.decisionLevel() == 0) kernel.components(*this);
+        noc_status res = conds.visit([&](const auto& satisfy) {
+            return kernel.filter(*this, satisfy);
+        });
+        return res != NOC_CONFLICT;
     }
     
     //-------------------------------------------------------------------------
@@ -231,12 +249,22 @@ private:
     vec<WinningCondition*>& winConditions;
     int printtype;
     parity_type playerSAT;
+    bool parityScc;
+    bool weightCycles;
+    bool sccMemo;
+    bool symmetry;
+    warm_type warmStart;
+    int32_t warmEdges = 0;              // edges of the first descent
+    int32_t symGroups = 0;              // LDSB groups of interchangeable blocks
+    int32_t symRows = 0;                // ... and their blocks
 public:
 
     NOCModel(Game& g, vec<WinningCondition*>& winConditions, 
-        int printtype=0, parity_type playerSAT=EVEN) 
-    :g(g), winConditions(winConditions), printtype(printtype), 
-        playerSAT(playerSAT)
+        const NOCOptions& o=NOCOptions()) 
+    :g(g), winConditions(winConditions), printtype(o.printtype), 
+        playerSAT(o.playerSAT), parityScc(o.parityScc),
+        weightCycles(o.weightCycles), sccMemo(o.sccMemo),
+        symmetry(o.symmetry), warmStart(o.warmStart)
     {
         V.growTo(g.nvertices);
         setupConstraints();
@@ -246,12 +274,14 @@ public:
 
     void setupConstraints() {
 
-        // Creating variables and fixing domains for playerSAT's vertices
+        // Creating variables and fixing domains for playerSAT's vertices.
+        // Literals are eager, so "V >= 0" and "V == i" come from the
+        // variables themselves instead of one reified copy per edge.
         for (size_t v=0; v<g.nvertices; v++) {
             if (g.owners[v]==playerSAT) {
-                createVar(V[v],-1,g.outs[v].size()-1);
+                createVar(V[v],-1,g.outs[v].size()-1,true);
             } else { // opponent' vertices
-                createVar(V[v],-1,0);
+                createVar(V[v],-1,0,true);
             }
         }
 
@@ -260,47 +290,152 @@ public:
 
         // Connection vertices (V_v -> V_w)
         for (size_t v=0; v<g.nvertices; v++) {
-            if (g.owners[v] == playerSAT) {
-                for (size_t i=0; i<g.outs[v].size(); i++) {
-                    int32_t e = g.outs[v][i];
-                    int32_t w = g.targets[e];
-                    BoolView sel = newBoolVar();
-                    int_rel_reif(V[v], IRT_EQ, i, sel);
-                    BoolView geq = newBoolVar();
-                    int_rel_reif(V[w], IRT_GE, 0, geq);
-                    vec<Lit> clause;
-                    clause.push(sel.getLit(false));
-                    clause.push(geq.getLit(true));
-                    sat.addClause(clause);
-                }
-            }
-            else {
-                BoolView sel = newBoolVar();
-                int_rel_reif(V[v],IRT_GE, 0, sel);
-                for (size_t i=0; i<g.outs[v].size(); i++) {
-                    int32_t e = g.outs[v][i];
-                    int32_t w = g.targets[e];
-                    BoolView geq = newBoolVar();
-                    int_rel_reif(V[w], IRT_GE,  0, geq);
-                    vec<Lit> clause;
-                    clause.push(sel.getLit(false));
-                    clause.push(geq.getLit(true));
-                    sat.addClause(clause);
-                }
+            Lit active = V[v]->getLit(0, LR_GE);
+            for (size_t i=0; i<g.outs[v].size(); i++) {
+                int32_t e = g.outs[v][i];
+                int32_t w = g.targets[e];
+                Lit sel = g.owners[v] == playerSAT
+                        ? V[v]->getLit(i, LR_EQ) : active;
+                vec<Lit> clause;
+                clause.push(~sel);
+                clause.push(V[w]->getLit(0, LR_GE));
+                sat.addClause(clause);
             }
         }
 
         // --------------------------------------------------------------------
         // Every infinite OPPONENT play must be avoided regarding codition.
-        new NOCPropagator(g,V,playerSAT,winConditions);
+        vec<WinningCondition*> pathConditions;
+        CycleChecks* cycles = CycleChecks::create(g, winConditions, 
+                                    playerSAT, parityScc, weightCycles,
+                                    pathConditions);
+        new NOCPropagator(g,V,playerSAT,pathConditions,cycles,sccMemo);
+        if (symmetry) setupSymmetries();
 
         //---------------------------------------------------------------------
 
         // branch(V, VAR_INORDER, VAL_MIN);
+        if (warmStart != WARM_NONE) setupWarmStart();
         engine.branching->add(new NOCBrancher(g,V,playerSAT)); //in progress
         output_vars(V);
     }
 
+    //-------------------------------------------------------------------------
+    // The first descent follows the strategy of a cheap engine, until the
+    // first conflict. Every PLAYER vertex also starts from the strategy edge
+    // as its value, as if it came from a previous solution.
+
+    void setupWarmStart() {
+        WarmStart ws(g, warmStart, playerSAT);
+        auto index = [&](int32_t e) {
+            int32_t v = g.sources[e];
+            int32_t j = 0;
+            while (g.outs[v][j] != e) j++;
+            return j;
+        };
+        vec<Lit> decs;
+        for (int32_t e : ws.decisions) {
+            decs.push(V[g.sources[e]]->getLit(index(e), LR_EQ));
+        }
+        for (int32_t v=0; v<g.nvertices; v++) {
+            if (g.owners[v] != playerSAT || ws.strategy[v] < 0) continue;
+            V[v]->sbps_value_selection = true;
+            V[v]->last_solution_value = index(ws.strategy[v]);
+        }
+        warmEdges = decs.size();
+        engine.branching->add(new WarmStartBrancher(decs));
+    }
+
+    //-------------------------------------------------------------------------
+    // Interchangeable blocks, each group given to LDSB as rows of vertex
+    // variables. Every constraint is on the game alone, so a swap of blocks
+    // maps solutions and learnt clauses to solutions and learnt clauses.
+
+    void setupSymmetries() {
+        BlockSymmetry sym(g, playerSAT);
+        for (auto& group : sym.groups) {
+            vec<IntVar*> x;
+            for (int32_t v : group.vertices) x.push(V[v]);
+            var_seq_sym_ldsb(group.rows, group.cols, x);
+            symGroups++;
+            symRows += group.rows;
+        }
+        if (symGroups) so.ldsb = true;
+    }
+
+    //-------------------------------------------------------------------------
+    // Enumeration projected onto the PLAYER choices, as in Chuffed-bool: each
+    // strategy found blocks the values of the PLAYER vertices with more than
+    // one edge that it reaches from init. At most 'limit' (0 for all); returns
+    // how many were found. With --symmetry, one strategy per LDSB class.
+
+    int64_t enumerate(int64_t limit, std::ostream& out) {
+        int64_t found = 0;
+        std::vector<char> reached(g.nvertices);
+        std::vector<int32_t> queue;
+        vec<Lit> clause;
+
+        // Read at the solution itself: Chuffed backtracks before returning.
+        engine.setSolutionCallback([&](Problem*) {
+            found++;
+            if (printtype) {
+                print(out);
+                out << "\n----------" << std::endl;
+            }
+            std::fill(reached.begin(), reached.end(), 0);
+            queue.assign(1, g.init);
+            reached[g.init] = 1;
+            clause.clear();
+            for (size_t q=0; q<queue.size(); q++) {
+                int32_t v = queue[q];
+                size_t from = 0, to = g.outs[v].size();
+                if (g.owners[v] == playerSAT) {
+                    from = V[v]->getVal();
+                    to = from + 1;
+                    Lit l = V[v]->getLit(from, LR_EQ);
+                    if (g.outs[v].size() > 1 && !sat.isRootLevel(var(l))) {
+                        clause.push(~l);
+                    }
+                }
+                for (size_t i=from; i<to; i++) {
+                    int32_t w = g.targets[g.outs[v][i]];
+                    if (!reached[w]) { reached[w] = 1; queue.push_back(w); }
+                }
+            }
+        });
+
+        int nof_solutions = so.nof_solutions;
+        so.nof_solutions = 1;
+        engine.solve(this);
+        while (engine.solutions) {
+            if (limit && found == limit) break;
+            if (clause.size() == 0) break;  // the only strategy there is
+
+            sat.btToLevel(0);
+            sat.addClause(clause);
+            engine.solutions = 0;
+            engine.search();
+        }
+        so.nof_solutions = nof_solutions;
+        engine.setSolutionCallback(nullptr);
+        return found;
+    }
+
+    //-------------------------------------------------------------------------
+    // The groups of interchangeable blocks given to LDSB and the edges of the
+    // warm start, in Chuffed's own statistics format.
+
+    void statistics() {
+        if (symmetry) {
+            std::cout << "%%%mzn-stat: symmetryGroups=" << symGroups
+                      << "\n%%%mzn-stat: symmetryBlocks=" << symRows
+                      << std::endl;
+        }
+        if (warmStart != WARM_NONE) {
+            std::cout << "%%%mzn-stat: warmStartEdges=" << warmEdges << std::endl;
+        }
+    }
+
     //-------------------------------------------------------------------------
 
     void print(std::ostream& out) override {
@@ -19,9 +19,22 @@
 #include <gecode/int.hh>
 #include <gecode/minimodel.hh>
 #include "iostream"
+#include <memory>
 
-#ifndef WINNING_CONDITIONS_H
-#include "winning_conditions.h"
+#ifndef NOC_OPTIONS_H
+#include "noc_options.h"
+#endif
+
+#ifndef CONDITION_SET_H
+#include "condition_set.h"
+#endif
+
+#ifndef CYCLE_CHECKS_H
+#include "cycle_checks.h"
+#endif
+
+#ifndef NOC_KERNEL_H
+#include "noc_kernel.h"
 #endif
 
 namespace Gecode {
@@ -29,21 +42,61 @@ namespace Gecode {
 //=============================================================================
 
 class NOCPropagator : public Propagator {
+public:
+    // The kernel's view of one propagation: edges are Boolean views, and a
+    // bad cycle fails its last edge in 'home'.
+    struct Adapter {
+        NOCPropagator& p;
+        Space& home;
+
+        bool isTrueEdge(int32_t e)  { return p.E[e].one(); }
+        bool isFalseEdge(int32_t e) { return p.E[e].zero(); }
+        bool isNewEdge(int32_t e)   { return false; }
+        bool leadsToNew(int32_t v)  { return true; }
+        bool isRootEdge(int32_t e)  { return false; }
+
+        noc_status closeCycle(int32_t index, bool bad) {
+            int32_t e = p.scratch->kernel.path.E.last();
+            if (bad && me_failed(p.E[e].zero(home))) return NOC_CONFLICT;
+            return NOC_STAY;
+        }
+    };
+
+    // Buffers for one propagation, owned by the model and shared by all its
+    // spaces, so propagation allocates nothing once they have grown. The
+    // kernel is mutable, so the search must run in a single thread. The
+    // memo's components are refined in the first propagation, in the root
+    // space every other space descends from.
+    struct Scratch {
+        ConditionSet conds;
+        NOCKernel<Adapter> kernel;
+        bool rooted = false;
+        std::vector<int8_t> state;
+        std::vector<CycleCheck::Cut> cuts;
+        Scratch(Game& g, vec<WinningCondition*>& winConditions,
+                parity_type playerSAT, bool sccMemo)
+        :   conds(winConditions,playerSAT), kernel(g,false,sccMemo),
+            state(g.nedges) {}
+        Scratch(const Scratch&) = delete;
+        Scratch& operator=(const Scratch&) = delete;
+    };
+
 protected:
     Game& g;
     ViewArray<Int::BoolView> V;
     ViewArray<Int::BoolView> E;
     parity_type playerSAT;
-    vec<WinningCondition*> winConditions;
+    CycleChecks* cycles;                // owned by the model, or nullptr
+    Scratch* scratch;                   // owned by the model
 public:
 
     NOCPropagator(Space& home, Game& g,
                     ViewArray<Int::BoolView> vs,
                     ViewArray<Int::BoolView> es,
                     parity_type playerSAT, 
-                    vec<WinningCondition*> winConditions)
+                    CycleChecks* cycles, Scratch* scratch)
     :   Propagator(home), g(g), V(vs), E(es), 
-        playerSAT(playerSAT), winConditions(winConditions)
+        playerSAT(playerSAT), cycles(cycles), scratch(scratch)
     {
         V.subscribe(home, *this, Int::PC_BOOL_VAL);
         E.subscribe(home, *this, Int::PC_BOOL_VAL);
@@ -55,9 +108,9 @@ public:
         Game& g,
         ViewArray<Int::BoolView> vs,
         ViewArray<Int::BoolView> es,
-        parity_type playerSAT, vec<WinningCondition*> winConditions)
+        parity_type playerSAT, CycleChecks* cycles, Scratch* scratch)
     {
-        new (home) NOCPropagator(home, g, vs, es, playerSAT, winConditions);
+        new (home) NOCPropagator(home, g, vs, es, playerSAT, cycles, scratch);
         return ES_OK;
     }
     
@@ -65,7 +118,8 @@ public:
     
     NOCPropagator(Space& home, NOCPropagator& source) 
     :   Propagator(home,source), g(source.g),
-        playerSAT(source.playerSAT), winConditions(source.winConditions)
+        playerSAT(source.playerSAT), cycles(source.cycles),
+        scratch(source.scratch)
     {
         V.update(home, source.V);
         E.update(home, source.E);
@@ -80,14 +134,29 @@ public:
     // ------------------------------------------------------------------------
     
     virtual ExecStatus propagate(Space& home, const ModEventDelta&) {
-        vec<int32_t> pathV;
-        vec<int32_t> pathE;
-        vec<int64_t> pathW;
-
-        if (filter(home, pathV,pathE,pathW,g.init,-1,true) == ES_FAILED)
-            return ES_FAILED;
+        if (cycles) {
+            std::vector<int8_t>& state = scratch->state;
+            for (int32_t e=0; e<g.nedges; e++) {
+                state[e] = E[e].one() ? 1 : E[e].zero() ? -1 : 0;
+            }
+            std::vector<CycleCheck::Cut>& cuts = scratch->cuts;
+            cuts.clear();
+            cycles->check(state, cuts);
+            for (size_t i=0; i<cuts.size(); i++) {
+                if (me_failed(E[cuts[i].edge].zero(home))) return ES_FAILED;
+            }
+            if (scratch->conds.size() == 0) return ES_OK;
+        }
 
-        return ES_OK;
+        Adapter a{*this, home};
+        if (!scratch->rooted) {
+            scratch->kernel.components(a);
+            scratch->rooted = true;
+        }
+        noc_status res = scratch->conds.visit([&](const auto& satisfy) {
+            return scratch->kernel.filter(a, satisfy);
+        });
+        return res == NOC_CONFLICT ? ES_FAILED : ES_OK;
     }
     
     // ------------------------------------------------------------------------
@@ -112,88 +181,23 @@ public:
         return sizeof(*this);
     }
     
-    //-------------------------------------------------------------------------
-    
-    int findVertex(int32_t vertex,vec<int32_t>& path) {
-        for (int32_t i=0; i<path.size(); i++) {
-            if (path[i] == vertex) return i;
-        }
-        return -1;
-    }
-    
-    //-------------------------------------------------------------------------
-    
-    bool satisfiedConditions(   vec<int32_t>& pathV,vec<int32_t>& pathE,
-                                vec<int64_t>& pathW,int32_t index) {
-        if (playerSAT==EVEN) {
-            for (int32_t i=0; i<winConditions.size(); i++) {
-                if (!winConditions[i]->satisfy(pathV,pathE,pathW,index)) {
-                    return false;
-                }
-            }
-            return true;
-        }
-        else {
-            for (int32_t i=0; i<winConditions.size(); i++) {
-                if (winConditions[i]->satisfy(pathV,pathE,pathW,index)) {
-                    return true;
-                }
-            }
-            return false;
-        }
-    }
-    
-    //-------------------------------------------------------------------------
-    
-    ExecStatus filter(  Space& home, vec<int32_t>& pathV, vec<int32_t>& pathE, 
-                        vec<int64_t>& pathW, int32_t v, 
-                        int32_t lastEdge, bool definedEdge) 
-    {
-        int32_t index = findVertex(v,pathV);
-        if (index >= 0) {
-
-            if (!satisfiedConditions(pathV,pathE,pathW,index)) {
-                if (me_failed(E[lastEdge].zero(home))) {
-                    return ES_FAILED;
-                }
-            }
-        }
-        else if (definedEdge) {
-            pathV.push(v);
-            for (size_t i=0; i<g.outs[v].size(); i++) {
-                int32_t e = g.outs[v][i];
-                if (E[e].zero()) continue;
-
-                int32_t w = g.targets[e];
-                int64_t acum = pathW.size() ? g.weights[e]+pathW.last()
-                                            : g.weights[e];
-                pathE.push(e);
-                pathW.push(acum);
-                ExecStatus status = 
-                    filter(home, pathV, pathE, pathW, w, e, E[e].one());
-                pathW.pop();
-                pathE.pop();
-                if (status == ES_FAILED) {
-                    return status;
-                }
-            }
-            pathV.pop();
-        }
-        return ES_OK;
-    }
 };
 
 //=============================================================================
+// The cycle checks and the scratch outlive the propagator: the caller owns
+// them, and shares them with every space of one search, which must run in a
+// single thread.
 
 void noopponentcyclegecode( Space& home, Game& g, 
                             const BoolVarArgs& v, 
                             const BoolVarArgs& e,
                             parity_type playerSAT, 
-                            vec<WinningCondition*> conditions)
+                            CycleChecks* cycles,
+                            NOCPropagator::Scratch* scratch)
 {
     ViewArray<Int::BoolView> V(home,v);
     ViewArray<Int::BoolView> E(home,e);
-    if (NOCPropagator::post(home,g,V,E,playerSAT,conditions) != ES_OK)
+    if (NOCPropagator::post(home,g,V,E,playerSAT,cycles,scratch) != ES_OK)
         home.fail();
 }
 
@@ -205,14 +209,24 @@ protected:
     BoolVarArray V;
     BoolVarArray E;
     vec<WinningCondition*>& winConditions;
-    int threshold;
     parity_type playerSAT;
+    bool parityScc;
+    bool weightCycles;
+    bool sccMemo;
+
+    // Cycle checks and propagation buffers, shared by every space cloned
+    // from this one and freed with the last of them. Both keep mutable
+    // marks, so DFS must run with a single thread.
+    std::shared_ptr<CycleChecks> cycles;
+    std::shared_ptr<NOCPropagator::Scratch> scratch;
 public:
 
     NocModel(Game& g, vec<WinningCondition*>& winConditions, 
-        parity_type playerSAT=EVEN) 
-    :   V(*this, g.nvertices, 0, 1),E(*this, g.nedges, 0, 1), g(g), 
-        winConditions(winConditions),threshold(threshold),playerSAT(playerSAT)
+        const NOCOptions& o=NOCOptions()) 
+    :   g(g), V(*this, g.nvertices, 0, 1), E(*this, g.nedges, 0, 1),
+        winConditions(winConditions), playerSAT(o.playerSAT),
+        parityScc(o.parityScc),
+        weightCycles(o.weightCycles), sccMemo(o.sccMemo)
     {
         setupConstraints();
         branch(*this, V, BOOL_VAR_NONE(), BOOL_VAL_MIN());
@@ -264,14 +278,24 @@ public:
 
         // --------------------------------------------------------------------
         // Every infinite OPPONENT play must be avoided regarding codition.
-        noopponentcyclegecode(*this,g,V,E,playerSAT,winConditions);
+        vec<WinningCondition*> pathConditions;
+        cycles.reset(CycleChecks::create(g, winConditions, 
+                                    playerSAT, parityScc, weightCycles,
+                                    pathConditions));
+        scratch = std::make_shared<NOCPropagator::Scratch>(
+                                    g, pathConditions, playerSAT, sccMemo);
+        noopponentcyclegecode(*this,g,V,E,playerSAT,cycles.get(),
+                              scratch.get());
     }
 
     // ------------------------------------------------------------------------
     
     NocModel(NocModel& source) 
     : Space(source), g(source.g), winConditions(source.winConditions), 
-        threshold(source.threshold), playerSAT(source.playerSAT) 
+        playerSAT(source.playerSAT),
+        parityScc(source.parityScc),
+        weightCycles(source.weightCycles), sccMemo(source.sccMemo),
+        cycles(source.cycles), scratch(source.scratch)
     {
         V.update(*this, source.V);
         E.update(*this, source.E);
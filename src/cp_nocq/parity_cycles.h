@@ -0,0 +1,230 @@
+/*
+ * Main authors:
+ *    Gonzalo Hernandez <gonzalo.hernandez@monash>
+ *    <gonzalo.hernandez@udenar.edu.co>
+ *
+ * Contributing authors:
+ *    Guido Tack <guido.tack@monash.edu>
+ *    Julian Gutierrez <J.Gutierrez@sussex.ac.uk>
+ *
+ * This file is part of NOCQ (a CP Toolchain for parity games with quantitative
+ * conditions).
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public License,
+ * v. 2.0. If a copy of the MPL was not distributed with this file, You can get
+ * one at https://mozilla.org/MPL/2.0/.
+ *
+ *-----------------------------------------------------------------------------
+ */
+#ifndef PARITY_CYCLES_H
+#define PARITY_CYCLES_H
+
+#ifndef CYCLE_CHECK_H
+#include "cycle_check.h"
+#endif
+
+#include <vector>
+#include <algorithm>
+
+//=============================================================================
+// Polynomial replacement of the path enumeration for ParityCondition. A bad
+// cycle (best priority p of the wrong parity) reachable from init exists
+// exactly when some vertex of priority p lies in a non-trivial SCC of the
+// committed subgraph restricted to priorities not better than p.
+
+class ParityCycles : public CycleCheck {
+private:
+    std::vector<int32_t> fwd;           // BFS edge from the bad vertex
+    std::vector<int32_t> bwd;           // BFS edge towards the bad vertex
+    std::vector<int32_t> markC;         // per check()
+    std::vector<int32_t> markF, markB;  // per search from a bad vertex
+    int32_t visit = 0;
+
+    std::vector<int32_t> comp, index, low;
+    std::vector<int32_t> compSize;
+
+    bool inLayer(int32_t v, int64_t p) const {
+        return isReached(v) && !g.isBetter(g.priors[v], p);
+    }
+
+    //-------------------------------------------------------------------------
+    // Iterative Tarjan over the reachable true edges of layer p.
+
+    void components(int64_t p) {
+        int32_t counter = 0, ncomps = 0;
+        std::vector<int32_t> stack;
+        std::vector<std::pair<int32_t,size_t>> frames;
+        compSize.clear();
+        for (int32_t v : reached) { index[v] = -1; comp[v] = -1; }
+
+        for (int32_t s : reached) {
+            if (!inLayer(s,p) || index[s] != -1) continue;
+            index[s] = low[s] = counter++;
+            stack.push_back(s);
+            frames.push_back({s,0});
+
+            while (!frames.empty()) {
+                int32_t v = frames.back().first;
+                size_t& i = frames.back().second;
+                if (i < g.outs[v].size()) {
+                    int32_t e = g.outs[v][i++];
+                    int32_t w = g.targets[e];
+                    if (!isTrue(e) || !inLayer(w,p)) continue;
+                    if (index[w] == -1) {
+                        index[w] = low[w] = counter++;
+                        stack.push_back(w);
+                        frames.push_back({w,0});
+                    }
+                    else if (comp[w] == -1) {
+                        low[v] = std::min(low[v], index[w]);
+                    }
+                    continue;
+                }
+
+                frames.pop_back();
+                if (!frames.empty()) {
+                    int32_t u = frames.back().first;
+                    low[u] = std::min(low[u], low[v]);
+                }
+                if (low[v] != index[v]) continue;
+
+                int32_t w, size = 0;
+                do {
+                    w = stack.back(); stack.pop_back();
+                    comp[w] = ncomps;
+                    size++;
+                } while (w != v);
+                compSize.push_back(size);
+                ncomps++;
+            }
+        }
+    }
+
+    //-------------------------------------------------------------------------
+    // A cycle through x inside its component, closed by a true edge into x.
+
+    void conflict(int32_t x, std::vector<Cut>& cuts) {
+        std::vector<int32_t> queue(1,x);
+        markF[x] = ++visit;
+        fwd[x] = -1;
+        for (size_t q=0; q<queue.size(); q++) {
+            int32_t v = queue[q];
+            for (size_t j=0; j<g.outs[v].size(); j++) {
+                int32_t e = g.outs[v][j];
+                int32_t w = g.targets[e];
+                if (!isTrue(e) || comp[w] != comp[x]) continue;
+                if (w == x) {
+                    Cut& cut = newCut(e, cuts);
+                    addInitPath(x, cut);
+                    for (; fwd[v] >= 0; v = g.sources[fwd[v]]) {
+                        addEdge(fwd[v], cut);
+                    }
+                    return;
+                }
+                if (markF[w] == visit) continue;
+                markF[w] = visit;
+                fwd[w] = e;
+                queue.push_back(w);
+            }
+        }
+    }
+
+    //-------------------------------------------------------------------------
+    // Undecided edges u->w closing a cycle x ~> u -> w ~> x in layer p.
+
+    void cutsThrough(int32_t x, int64_t p, std::vector<Cut>& cuts) {
+        std::vector<int32_t> queue(1,x);
+        markB[x] = markF[x] = ++visit;
+        bwd[x] = fwd[x] = -1;
+        for (size_t q=0; q<queue.size(); q++) {
+            int32_t w = queue[q];
+            for (size_t j=0; j<g.ins[w].size(); j++) {
+                int32_t e = g.ins[w][j];
+                int32_t u = g.sources[e];
+                if (!isTrue(e) || markB[u] == visit) continue;
+                if (g.isBetter(g.priors[u], p)) continue;
+                markB[u] = visit;
+                bwd[u] = e;
+                queue.push_back(u);
+            }
+        }
+
+        queue.assign(1,x);
+        for (size_t q=0; q<queue.size(); q++) {
+            int32_t u = queue[q];
+            for (size_t j=0; j<g.outs[u].size(); j++) {
+                int32_t e = g.outs[u][j];
+                int32_t w = g.targets[e];
+                if ((*state)[e] == 0) {
+                    if (markB[w] != visit || markC[e] == round) continue;
+                    markC[e] = round;
+                    Cut& cut = newCut(e, cuts);
+                    addInitPath(x, cut);
+                    for (int32_t v=u; fwd[v] >= 0; v = g.sources[fwd[v]]) {
+                        addEdge(fwd[v], cut);
+                    }
+                    for (int32_t v=w; bwd[v] >= 0; v = g.targets[bwd[v]]) {
+                        addEdge(bwd[v], cut);
+                    }
+                    continue;
+                }
+                if (!isTrue(e) || !inLayer(w,p) || markF[w] == visit) continue;
+                markF[w] = visit;
+                fwd[w] = e;
+                queue.push_back(w);
+            }
+        }
+    }
+
+    //-------------------------------------------------------------------------
+
+public:
+    ParityCycles(Game& g, parity_type playerSAT)
+    :   CycleCheck(g, playerSAT),
+        fwd(g.nvertices), bwd(g.nvertices), markC(g.nedges,0),
+        markF(g.nvertices,0), markB(g.nvertices,0),
+        comp(g.nvertices), index(g.nvertices), low(g.nvertices)
+    {
+    }
+
+    //-------------------------------------------------------------------------
+
+    bool check(const std::vector<int8_t>& edgeState,
+               std::vector<Cut>& cuts) override
+    {
+        reach(edgeState);
+
+        std::vector<int64_t> bad;
+        for (int32_t v : reached) {
+            if (g.priors[v] % 2 != playerSAT) bad.push_back(g.priors[v]);
+        }
+        std::sort(bad.begin(), bad.end());
+        bad.erase(std::unique(bad.begin(), bad.end()), bad.end());
+
+        for (int64_t p : bad) {
+            components(p);
+            for (int32_t x : reached) {
+                if (g.priors[x] != p) continue;
+                bool loop = false;
+                for (size_t j=0; j<g.outs[x].size(); j++) {
+                    int32_t e = g.outs[x][j];
+                    if (isTrue(e) && g.targets[e] == x) loop = true;
+                }
+                if (compSize[comp[x]] > 1 || loop) {
+                    conflict(x, cuts);
+                    return false;
+                }
+            }
+        }
+
+        for (int64_t p : bad) {
+            for (int32_t x : reached) {
+                if (g.priors[x] != p) continue;
+                cutsThrough(x, p, cuts);
+            }
+        }
+        return true;
+    }
+};
+
+#endif // PARITY_CYCLES_H
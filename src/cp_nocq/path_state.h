@@ -0,0 +1,129 @@
+/*
+ * Main authors:
+ *    Gonzalo Hernandez <gonzalo.hernandez@monash>
+ *    <gonzalo.hernandez@udenar.edu.co>
+ *
+ * Contributing authors:
+ *    Guido Tack <guido.tack@monash.edu>
+ *    Julian Gutierrez <J.Gutierrez@sussex.ac.uk>
+ *
+ * This file is part of NOCQ (a CP Toolchain for parity games with quantitative
+ * conditions).
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public License,
+ * v. 2.0. If a copy of the MPL was not distributed with this file, You can get
+ * one at https://mozilla.org/MPL/2.0/.
+ *
+ *-----------------------------------------------------------------------------
+ */
+#ifndef PATH_STATE_H
+#define PATH_STATE_H
+
+#ifndef GAME_H
+#include "../utils/game.h"
+#endif
+
+#include "chuffed/support/vec.h"
+
+#include <vector>
+#include <algorithm>
+
+//=============================================================================
+// The path a NOC propagator is enumerating. Membership is a position array,
+// the best priority of any suffix comes from a sparse table that grows and
+// shrinks with the path, and W keeps prefix weight sums, so closing a cycle
+// costs O(1) per condition instead of a scan of the path.
+//
+// V[i] is the i-th vertex and E[i] the edge leaving it; when E is as long as
+// V, its last edge is being tried. next[i] is the position in outs[V[i]] the
+// enumeration resumes from, so the path doubles as the DFS frame stack. All
+// buffers keep their capacity, so a propagator that owns one allocates
+// nothing once it has seen its longest path.
+//
+// Priorities enter the table multiplied by 'sign', so that the best one is
+// the smallest whatever the objective and merging two entries is a plain min.
+
+class PathState {
+private:
+    Game& g;
+    std::vector<int32_t> position;      // index on the path, -1 when off it
+    const int64_t sign;                 // 1 for MIN, -1 for MAX
+
+    // best[j][k-2^j+1]: sign * best priority among V[k-2^j+1..k]
+    std::vector<std::vector<int64_t>> best;
+
+    static int32_t log2(int32_t n) { return 31-__builtin_clz(n); }
+
+public:
+    vec<int32_t> V;
+    vec<int32_t> E;
+    vec<int64_t> W;                     // W[i]: weight of E[0..i]
+    vec<int32_t> next;
+
+    PathState(Game& g)
+    :   g(g), position(g.nvertices,-1), sign(g.objective==MIN ? 1 : -1)
+    {
+    }
+
+    //-------------------------------------------------------------------------
+
+    int32_t find(int32_t v) const { return position[v]; }
+
+    void pushVertex(int32_t v, int32_t first=0) {
+        int32_t k = V.size();
+        position[v] = k;
+        V.push(v);
+        next.push(first);
+        if (best.empty()) best.emplace_back();
+        best[0].push_back(sign*g.priors[v]);
+        for (int32_t j=1; (1<<j) <= k+1; j++) {
+            if ((int32_t)best.size() == j) best.emplace_back();
+            int32_t h = 1<<(j-1);
+            best[j].push_back(std::min(best[j-1][k-h+1], best[j-1][k-2*h+1]));
+        }
+    }
+
+    void popVertex() {
+        int32_t k = V.size()-1;
+        position[V.last()] = -1;
+        V.pop();
+        next.pop();
+        for (int32_t j=0; (1<<j) <= k+1; j++) best[j].pop_back();
+    }
+
+    void pushEdge(int32_t e) {
+        W.push(W.size() ? W.last()+g.weights[e] : g.weights[e]);
+        E.push(e);
+    }
+
+    void popEdge() {
+        W.pop();
+        E.pop();
+    }
+
+    void clear() {
+        while (V.size()) popVertex();
+        E.clear();
+        W.clear();
+    }
+
+    //-------------------------------------------------------------------------
+    // The cycle closed by the last edge runs from V[index] to the end.
+
+    int64_t bestPriority(int32_t index) const {
+        int32_t k = V.size()-1;
+        int32_t j = log2(k-index+1);
+        int32_t l = (1<<j)-1;
+        return sign*std::min(best[j][k-l], best[j][index]);
+    }
+
+    int64_t cycleWeight(int32_t index) const {
+        return W.last() - (index ? W[index-1] : 0);
+    }
+
+    int32_t cycleLength(int32_t index) const {
+        return E.size() - index;
+    }
+};
+
+#endif // PATH_STATE_H
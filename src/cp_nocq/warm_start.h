@@ -0,0 +1,90 @@
+/*
+ * Main authors:
+ *    Gonzalo Hernandez <gonzalo.hernandez@monash>
+ *    <gonzalo.hernandez@udenar.edu.co>
+ *
+ * Contributing authors:
+ *    Guido Tack <guido.tack@monash.edu>
+ *    Julian Gutierrez <J.Gutierrez@sussex.ac.uk>
+ *
+ * This file is part of NOCQ (a CP Toolchain for parity games with quantitative
+ * conditions).
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public License,
+ * v. 2.0. If a copy of the MPL was not distributed with this file, You can get
+ * one at https://mozilla.org/MPL/2.0/.
+ *
+ *-----------------------------------------------------------------------------
+ */
+#ifndef WARM_START_H
+#define WARM_START_H
+
+#ifndef ZIELONKA_H
+#include "../utils/zielonka.h"
+#endif
+
+#ifndef MPG_H
+#include "../utils/mpg.h"
+#endif
+
+#include <vector>
+#include <stdexcept>
+
+//=============================================================================
+// A positional strategy from a cheap engine, for the first descent of a CP
+// search: Zielonka's algorithm on the priorities alone, or strategy iteration
+// on the mean payoff of the weights. Nothing relies on it being winning for
+// the conditions at hand; the solver only tries it first. A game with dead
+// ends has no mean payoff, so it gets no mpg strategy.
+//
+// The decisions are the PLAYER edges of the strategy met by a breadth-first
+// walk from init, which follows the strategy at PLAYER vertices and every
+// edge elsewhere. A vertex the engine gives no edge stops the walk there.
+
+class WarmStart {
+public:
+    std::vector<int32_t> strategy;      // edge chosen at each vertex, or -1
+    std::vector<int32_t> decisions;     // PLAYER edges reached from init
+
+    WarmStart(Game& g, warm_type engine, parity_type player)
+    :   strategy(g.nvertices, -1)
+    {
+        if (engine == WARM_ZIELONKA) {
+            Zielonka zlk(g);
+            zlk.solve();
+            strategy.assign(zlk.strategy.begin(), zlk.strategy.end());
+        }
+        else if (engine == WARM_MPG) {
+            try {
+                MeanPayoffSI mpg(g, 1);
+                mpg.solve();
+                strategy = mpg.getStrategy();
+            } catch (const std::invalid_argument&) {
+                // Dead ends: no mean payoff, so no warm start either.
+            }
+        }
+
+        std::vector<char> seen(g.nvertices, 0);
+        std::vector<int32_t> queue = {g.init};
+        seen[g.init] = 1;
+        for (size_t q=0; q<queue.size(); q++) {
+            int32_t v = queue[q];
+            for (size_t j=0; j<g.outs[v].size(); j++) {
+                int32_t e = g.outs[v][j];
+                if (g.owners[v] == player) {
+                    if (e != strategy[v]) continue;
+                    decisions.push_back(e);
+                }
+                int32_t w = g.targets[e];
+                if (!seen[w]) { seen[w] = 1; queue.push_back(w); }
+            }
+        }
+    }
+
+    // True when e is the edge the strategy keeps at its source.
+    bool chosen(Game& g, int32_t e) const {
+        return strategy[g.sources[e]] == e;
+    }
+};
+
+#endif // WARM_START_H
@@ -0,0 +1,205 @@
+/*
+ * Main authors:
+ *    Gonzalo Hernandez <gonzalo.hernandez@monash>
+ *    <gonzalo.hernandez@udenar.edu.co>
+ *
+ * Contributing authors:
+ *    Guido Tack <guido.tack@monash.edu>
+ *    Julian Gutierrez <J.Gutierrez@sussex.ac.uk>
+ *
+ * This file is part of NOCQ (a CP Toolchain for parity games with quantitative
+ * conditions).
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public License,
+ * v. 2.0. If a copy of the MPL was not distributed with this file, You can get
+ * one at https://mozilla.org/MPL/2.0/.
+ *
+ *-----------------------------------------------------------------------------
+ */
+#ifndef WEIGHT_CYCLES_H
+#define WEIGHT_CYCLES_H
+
+#ifndef CYCLE_CHECK_H
+#include "cycle_check.h"
+#endif
+
+#include <vector>
+#include <queue>
+#include <functional>
+
+//=============================================================================
+// Polynomial replacement of the path enumeration for EnergyCondition (with
+// threshold 0) and MeanPayoffCondition. A cycle of length l and weight s is
+// bad for EVEN when q*s - p*l < 0, with threshold p/q (0/1 for energy), so
+// edges cost q*w-p and the check looks for a negative cycle. For ODD a bad
+// cycle has q*s - p*l >= 0, which the cost (n+1)*(p-q*w)-1 turns into a
+// negative cycle as well, since l <= n.
+//
+// Bellman-Ford by rounds over the true edges reachable from init: a cycle of
+// the predecessor graph is a negative cycle and becomes the conflict. When
+// there is none, the distances are potentials for Dijkstra: an undecided
+// edge u->w of cost c is cut when the cheapest true path w ~> u costs less
+// than -c.
+
+class WeightCycles : public CycleCheck {
+private:
+    std::vector<__int128> cost;         // one per edge
+    std::vector<__int128> dist;         // Bellman-Ford potentials
+    std::vector<int32_t> pred;          // Bellman-Ford edge into a vertex
+    std::vector<int32_t> markQ, markP;
+    int32_t walk = 0;
+
+    std::vector<__int128> reduced;      // Dijkstra distances, from 'source'
+    std::vector<int32_t> back;          // Dijkstra edge into a vertex
+    std::vector<int32_t> markD;
+    int32_t source = 0;
+
+    //-------------------------------------------------------------------------
+    // A cycle of the predecessor graph above v, or -1. Walks of the same
+    // round stop at vertices already walked, which are known to be acyclic.
+
+    int32_t predCycle(int32_t v, int32_t first) {
+        walk++;
+        while (v >= 0 && markP[v] < first) {
+            markP[v] = walk;
+            v = pred[v] >= 0 ? g.sources[pred[v]] : -1;
+        }
+        return v >= 0 && markP[v] == walk ? v : -1;
+    }
+
+    void conflict(int32_t x, std::vector<Cut>& cuts) {
+        Cut& cut = newCut(pred[x], cuts);
+        addInitPath(x, cut);
+        for (int32_t v = g.sources[pred[x]]; v != x; v = g.sources[pred[v]]) {
+            addEdge(pred[v], cut);
+        }
+    }
+
+    //-------------------------------------------------------------------------
+    // Returns a vertex on a negative cycle, or -1 with 'dist' feasible.
+
+    int32_t bellmanFord() {
+        std::vector<int32_t> queue, next;
+        for (int32_t v : reached) {
+            dist[v] = 0;
+            pred[v] = -1;
+            queue.push_back(v);
+        }
+        while (!queue.empty()) {
+            int32_t first = ++walk;
+            next.clear();
+            for (int32_t u : queue) {
+                for (size_t j=0; j<g.outs[u].size(); j++) {
+                    int32_t e = g.outs[u][j];
+                    int32_t w = g.targets[e];
+                    if (!isTrue(e) || dist[u]+cost[e] >= dist[w]) continue;
+                    dist[w] = dist[u]+cost[e];
+                    pred[w] = e;
+                    if (markQ[w] == first) continue;
+                    markQ[w] = first;
+                    next.push_back(w);
+                }
+            }
+            queue.swap(next);
+
+            first = walk+1;
+            for (int32_t v : queue) {
+                int32_t x = predCycle(v, first);
+                if (x >= 0) return x;
+            }
+        }
+        return -1;
+    }
+
+    //-------------------------------------------------------------------------
+    // Dijkstra from w on reduced costs, up to 'limit'.
+
+    void dijkstra(int32_t w, __int128 limit) {
+        typedef std::pair<__int128,int32_t> item;
+        std::priority_queue<item, std::vector<item>, std::greater<item>> heap;
+        source++;
+        markD[w] = source;
+        reduced[w] = 0;
+        back[w] = -1;
+        heap.push({0,w});
+        while (!heap.empty()) {
+            __int128 d = heap.top().first;
+            int32_t u = heap.top().second;
+            heap.pop();
+            if (d != reduced[u]) continue;
+            for (size_t j=0; j<g.outs[u].size(); j++) {
+                int32_t e = g.outs[u][j];
+                int32_t x = g.targets[e];
+                if (!isTrue(e) || !isReached(x)) continue;
+                __int128 r = d + cost[e] + dist[u] - dist[x];
+                if (r >= limit) continue;
+                if (markD[x] == source && r >= reduced[x]) continue;
+                markD[x] = source;
+                reduced[x] = r;
+                back[x] = e;
+                heap.push({r,x});
+            }
+        }
+    }
+
+    //-------------------------------------------------------------------------
+
+    void cutsInto(int32_t w, std::vector<Cut>& cuts) {
+        __int128 limit = 0;
+        for (size_t j=0; j<g.ins[w].size(); j++) {
+            int32_t e = g.ins[w][j];
+            int32_t u = g.sources[e];
+            if ((*state)[e] != 0 || !isReached(u)) continue;
+            __int128 r = cost[e] + dist[u] - dist[w];
+            if (-r > limit) limit = -r;
+        }
+        if (limit == 0) return;
+
+        dijkstra(w, limit);
+        for (size_t j=0; j<g.ins[w].size(); j++) {
+            int32_t e = g.ins[w][j];
+            int32_t u = g.sources[e];
+            if ((*state)[e] != 0 || !isReached(u)) continue;
+            if (markD[u] != source) continue;
+            if (reduced[u] + cost[e] + dist[u] - dist[w] >= 0) continue;
+            Cut& cut = newCut(e, cuts);
+            addInitPath(u, cut);
+            for (int32_t v=u; back[v] >= 0; v = g.sources[back[v]]) {
+                addEdge(back[v], cut);
+            }
+        }
+    }
+
+    //-------------------------------------------------------------------------
+
+public:
+    WeightCycles(Game& g, parity_type playerSAT, int64_t p, int64_t q)
+    :   CycleCheck(g, playerSAT),
+        cost(g.nedges), dist(g.nvertices), pred(g.nvertices),
+        markQ(g.nvertices,0), markP(g.nvertices,0),
+        reduced(g.nvertices), back(g.nvertices), markD(g.nvertices,0)
+    {
+        for (int32_t e=0; e<g.nedges; e++) {
+            __int128 c = (__int128)q*g.weights[e]-p;
+            if (playerSAT == EVEN) cost[e] = c;
+            else cost[e] = -c*(g.nvertices+1)-1;
+        }
+    }
+
+    //-------------------------------------------------------------------------
+
+    bool check(const std::vector<int8_t>& edgeState,
+               std::vector<Cut>& cuts) override
+    {
+        reach(edgeState);
+        int32_t x = bellmanFord();
+        if (x >= 0) {
+            conflict(x, cuts);
+            return false;
+        }
+        for (int32_t w : reached) cutsInto(w, cuts);
+        return true;
+    }
+};
+
+#endif // WEIGHT_CYCLES_H
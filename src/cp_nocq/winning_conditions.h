@@ -23,7 +23,9 @@
 #include "../utils/game.h"
 #endif
 
-#include "chuffed/support/vec.h"
+#ifndef PATH_STATE_H
+#include "path_state.h"
+#endif
 
 //=============================================================================
 
@@ -39,10 +41,8 @@ public:
     }
     virtual ~WinningCondition() = default;
     //-----------------------------------------------------------------------
-    virtual bool satisfy(   vec<int32_t>& pathV,
-                            vec<int32_t>& pathE,
-                            vec<int64_t>& pathW,
-                            int32_t cycleIndex ) = 0;
+    // The cycle closed by the last edge of 'path' starts at cycleIndex.
+    virtual bool satisfy(const PathState& path, int32_t cycleIndex) = 0;
 };
 
 //===========================================================================
@@ -51,18 +51,9 @@ class ParityCondition : public WinningCondition {
     using WinningCondition::WinningCondition;
 public:
 
-    bool satisfy(   vec<int32_t>& pathV,
-                    vec<int32_t>& pathE,
-                    vec<int64_t>& pathW,
-                    int32_t cycleIndex ) override 
+    bool satisfy(const PathState& path, int32_t cycleIndex) override
     {
-        int64_t m = g.priors[pathV[cycleIndex]];
-        for (int32_t i=cycleIndex+1; i<pathV.size(); i++) {
-            if (g.isBetter(g.priors[pathV[i]],m)) {
-                m = g.priors[pathV[i]];
-            }
-        }
-        return m%2==playerSAT;
+        return path.bestPriority(cycleIndex)%2==playerSAT;
     }
 };
 
@@ -75,15 +66,12 @@ private:
 public:
 
     void setThreshold(int64_t t) { threshold = t; }
+    int64_t getThreshold() const { return threshold; }
     
-    bool satisfy(   vec<int32_t>& pathV,
-                    vec<int32_t>& pathE,
-                    vec<int64_t>& pathW,
-                    int32_t cycleIndex ) override 
+    bool satisfy(const PathState& path, int32_t cycleIndex) override
     {
-        int64_t sum = 0;
-        sum = pathW.last()-pathW[cycleIndex]+g.weights[pathE[cycleIndex]];
-        
+        int64_t sum = path.cycleWeight(cycleIndex);
+
         if (playerSAT == EVEN) {
             return sum >= threshold;
         }
@@ -97,23 +85,27 @@ class MeanPayoffCondition : public WinningCondition {
     using WinningCondition::WinningCondition;
 private:
     double threshold;
+    int64_t p = 0;                      // threshold as a decimal fraction p/q
+    int64_t q = 1;
 public:
 
-    void setThreshold(double t) { threshold = t; }
+    void setThreshold(double t) {
+        threshold = t;
+        decimalFraction(t, p, q);
+    }
+    double getThreshold() const { return threshold; }
+    void getFraction(int64_t& num, int64_t& den) const { num = p; den = q; }
 
-    bool satisfy(   vec<int32_t>& pathV,
-                    vec<int32_t>& pathE,
-                    vec<int64_t>& pathW,
-                    int32_t cycleIndex ) override 
+    bool satisfy(const PathState& path, int32_t cycleIndex) override
     {
-        int64_t sum = 0;
-        sum = pathW.last()-pathW[cycleIndex]+g.weights[pathE[cycleIndex]];
-        double avg = static_cast<double>(sum) / (pathE.size() - cycleIndex);
+        // mean >= p/q, without dividing
+        __int128 lhs = (__int128)q*path.cycleWeight(cycleIndex);
+        __int128 rhs = (__int128)p*path.cycleLength(cycleIndex);
 
         if (playerSAT == EVEN) {
-            return avg >= threshold;
+            return lhs >= rhs;
         }
-        return avg < threshold;
+        return lhs < rhs;
     }
 };
 
@@ -16,12 +16,17 @@
  * 
  *-----------------------------------------------------------------------------
  */
+#include <iomanip>
 #include "utils/dbg.h"
 #include "utils/parameters.h"
 #include "utils/fra.h"
 #include "utils/game.h"
 #include "utils/tarjan.h"
 #include "utils/zielonka.h"
+#include "utils/fpi.h"
+#include "utils/epm.h"
+#include "utils/mpg.h"
+#include "utils/energyparity.h"
 #include "utils/satencoder.h"
 #include "cp_nocq/nocq_chuffed_bool.cpp"
 #include "cp_nocq/nocq_chuffed_int.cpp"
@@ -50,16 +55,28 @@ int main(int argc, char *argv[])
     if (options.method=="" && options.solver!="") {
         options.method="noc-even";
     }
-    if (options.method.substr(0,3)=="noc" && options.solver=="") {
+    if ((options.method.substr(0,3)=="noc" || options.method=="mpg-search")
+        && options.solver=="") {
         options.solver="chuffed-bool";
     }
     if (options.parityCond || options.energyCond || options.meanpayoffCond) {
         if (options.method=="") options.method = "noc-even";
         if (options.solver=="") options.solver = "chuffed-bool";
     }
-    if (!(options.parityCond || options.energyCond || options.meanpayoffCond)){
+    if (!(options.parityCond || options.energyCond || options.meanpayoffCond)
+        && options.method!="mpg-search") {
         options.parityCond = true;
     }
+    if (so.nof_solutions != 1 && !(options.method.substr(0,3)=="noc" &&
+        (options.solver=="chuffed-bool" || options.solver=="chuffed-int"))) {
+        std::cout << "Error: --nsolutions enumerates with --chuffed-bool"
+                  << " or --chuffed-int only.\n";
+        return 0;
+    }
+    if (options.initialCredit>=0 && options.method!="epm") {
+        std::cout << "Error: --credit is the initial credit of --epm only.\n";
+        return 0;
+    }
 
     //-------------------------------------------------------------------------
 
@@ -74,6 +91,64 @@ int main(int argc, char *argv[])
         return std::chrono::duration<double>(endTime - clockStorage).count();
     };
 
+    //-------------------------------------------------------------------------
+    // Output of the algorithms that solve the whole game at once
+
+    auto printInitTime = [&](double preptime) {
+        if (options.printTime>1 || options.printVerbose) {
+            std::cout << "Init time          : " << preptime << std::endl;
+        }
+        else if (options.printTime<-1) {
+            std::cout   << preptime << " " << std::flush;
+        }
+    };
+
+    auto printSolvingTime = [&](double totaltime) {
+        if (options.printTime>1 || options.printVerbose) {
+            std::cout << "Solving time       : " << totaltime << std::endl;
+        }
+        else if (options.printTime<0) {
+            std::cout   << totaltime << " " << std::flush;
+        }
+
+        if (options.printTime == 1) {
+            std::cout   << totaltime << " " << std::flush;
+        }
+    };
+
+    // One line per initial vertex with its result, label(v0).
+    auto printInitial = [&](auto label) {
+        for (size_t i=0; i<options.init.size(); i++) {
+            int32_t v0 = options.init[i];
+
+            if (options.printTime>=0 || options.printVerbose)
+                std::cout << v0 << ": " << label(v0) << " ";
+
+            std::cout << std::endl;
+        }
+    };
+
+    auto printWinners = [&](const std::array<std::vector<int>,2>& win) {
+        std::vector<bool> even(game->nvertices, false);
+        for (int v : win[0]) even[v] = true;
+
+        printInitial([&](int32_t v0) { return even[v0]?"EVEN":"ODD"; });
+
+        if (options.printSolution || options.printVerbose) {
+            std::cout << "EVEN {";
+            for (int i = 0; i < win[0].size(); i++) {
+                std::cout << win[0][i];
+                if (i<win[0].size()-1) std::cout << ",";
+            }
+            std::cout << "}\nODD  {";
+            for (int i = 0; i < win[1].size(); i++) {
+                std::cout << win[1][i];
+                if (i<win[1].size()-1) std::cout << ",";
+            }
+            std::cout << "}" <<std::endl;
+        }
+    };
+
     //-------------------------------------------------------------------------
 
     startClock(); //.............................................
@@ -139,24 +214,23 @@ int main(int argc, char *argv[])
 
     if (options.printVerbose) std::cout << "Winning Conditions : ";
 
+    parity_type playerSAT = (options.method=="noc-even" ||
+                             options.method=="mpg-search") ? EVEN : ODD;
     vec<WinningCondition*> winConditions;
     if (options.parityCond) {
-        ParityCondition* c = new ParityCondition(*game,
-                                    options.method=="noc-even"?EVEN:ODD);
+        ParityCondition* c = new ParityCondition(*game, playerSAT);
         winConditions.push(c);
         if (options.printVerbose) std::cout << "+parity ";
     }
     if (options.energyCond) {
-        EnergyCondition* c = new EnergyCondition(*game,
-                                    options.method=="noc-even"?EVEN:ODD);
+        EnergyCondition* c = new EnergyCondition(*game, playerSAT);
         c->setThreshold(options.thresholdEnergy);
         winConditions.push(c);
         if (options.printVerbose) 
             std::cout << "+energy (" << options.thresholdEnergy << ") ";
     }
     if (options.meanpayoffCond) {
-        MeanPayoffCondition* c = new MeanPayoffCondition(*game,
-                                    options.method=="noc-even"?EVEN:ODD);
+        MeanPayoffCondition* c = new MeanPayoffCondition(*game, playerSAT);
         c->setThreshold(options.thresholdMPG);
         winConditions.push(c);
         if (options.printVerbose) 
@@ -164,6 +238,24 @@ int main(int argc, char *argv[])
     }
     if (options.printVerbose) std::cout << "\n";
 
+    NOCOptions nocOptions;
+    nocOptions.printtype        = options.printSolution || options.printVerbose;
+    nocOptions.playerSAT        = playerSAT;
+    nocOptions.precision        = options.precisionMPG;
+    nocOptions.parityScc        = options.parityScc;
+    nocOptions.weightCycles     = options.weightCycles;
+    nocOptions.shortReasons     = options.shortReasons;
+    nocOptions.cycleNogoods     = options.cycleNogoods;
+    nocOptions.sccMemo          = options.sccMemo;
+    nocOptions.aliasEdges       = options.aliasEdges;
+    nocOptions.amo              = options.amo;
+    nocOptions.pmModel          = options.pmModel;
+    nocOptions.mpBound          = options.mpBound;
+    nocOptions.symmetry         = options.symmetry;
+    nocOptions.branch           = options.branch;
+    nocOptions.branchPriority   = options.branchPriority;
+    nocOptions.warmStart        = options.warmStart;
+
     //-------------------------------------------------------------------------
     // For testing purposes
 
@@ -176,9 +268,7 @@ int main(int argc, char *argv[])
     else if(options.method.substr(0,3)=="noc"&&options.solver=="chuffed-bool"){
         startClock(); //.............................................
         ChuffedBool::NOCModel* model = new ChuffedBool::NOCModel(
-                            *game, winConditions, 
-                            (options.printSolution || options.printVerbose),
-                            options.method=="noc-even"?EVEN:ODD);
+                            *game, winConditions, nocOptions);
 
         so.print_sol = options.printSolution || options.printVerbose;
         double preptime = stopClock(); //............................
@@ -190,19 +280,31 @@ int main(int argc, char *argv[])
             std::cout   << preptime << " " << std::flush;
         }
 
-        std::streambuf* old_buf = std::cout.rdbuf();
+        // Several solutions: the model enumerates strategies and streams them
+        // as they are found, while Chuffed's own output is discarded.
         std::stringstream ss;
-        std::cout.rdbuf(ss.rdbuf());
+        std::ostream discard(nullptr);
+        int64_t strategies = -1;
 
         startClock(); //.............................................
-        engine.solve(model);
+        if (so.nof_solutions != 1) {
+            so.print_sol = false;
+            engine.setOutputStream(discard);
+            strategies = model->enumerate(so.nof_solutions, std::cout);
+            engine.setOutputStream(std::cout);
+        }
+        else {
+            std::streambuf* old_buf = std::cout.rdbuf();
+            std::cout.rdbuf(ss.rdbuf());
+            engine.solve(model);
+            std::cout.rdbuf(old_buf);
+        }
         double totaltime = stopClock(); //...........................
 
-        std::cout.rdbuf(old_buf);
-
+        bool found = strategies >= 0 ? strategies > 0 : engine.solutions > 0;
         std::string answer = "";
-        if ((options.method == "noc-even" && engine.solutions) ||
-            (options.method != "noc-even" && !engine.solutions) ) {
+        if ((options.method == "noc-even" && found) ||
+            (options.method != "noc-even" && !found) ) {
             answer = "EVEN";
         } else {
             answer = "ODD";
@@ -224,9 +326,10 @@ int main(int argc, char *argv[])
 
         if (options.printTime>=0 || options.printVerbose) {
             std::cout   << answer;
+            if (strategies >= 0) std::cout << " (" << strategies << " strategies)";
         }
 
-        if (options.printSolution || options.printVerbose) {
+        if ((options.printSolution || options.printVerbose) && strategies < 0) {
             std::cout << "\n----------\n";
             std::cout << "\n" << ss.str();
         }
@@ -235,6 +338,7 @@ int main(int argc, char *argv[])
 
         if (options.printStatistics || options.printVerbose) {
             engine.printStats();
+            model->statistics();
         }
         
         delete model;
@@ -246,9 +350,7 @@ int main(int argc, char *argv[])
     else if (options.method.substr(0,3)=="noc"&&options.solver=="chuffed-int"){
         startClock(); //.............................................
         ChuffedInt::NOCModel* model = new ChuffedInt::NOCModel(
-                            *game, winConditions,
-                            (options.printSolution || options.printVerbose),
-                            options.method=="noc-even"?EVEN:ODD);
+                            *game, winConditions, nocOptions);
 
         so.print_sol = options.printSolution || options.printVerbose;
         double preptime = stopClock(); //............................
@@ -260,19 +362,29 @@ int main(int argc, char *argv[])
             std::cout   << preptime << " " << std::flush;
         }
 
-        std::streambuf* old_buf = std::cout.rdbuf();
         std::stringstream ss;
-        std::cout.rdbuf(ss.rdbuf());
+        std::ostream discard(nullptr);
+        int64_t strategies = -1;
 
         startClock(); //.............................................
-        engine.solve(model);
+        if (so.nof_solutions != 1) {
+            so.print_sol = false;
+            engine.setOutputStream(discard);
+            strategies = model->enumerate(so.nof_solutions, std::cout);
+            engine.setOutputStream(std::cout);
+        }
+        else {
+            std::streambuf* old_buf = std::cout.rdbuf();
+            std::cout.rdbuf(ss.rdbuf());
+            engine.solve(model);
+            std::cout.rdbuf(old_buf);
+        }
         double totaltime = stopClock(); //...........................
 
-        std::cout.rdbuf(old_buf);
-
+        bool found = strategies >= 0 ? strategies > 0 : engine.solutions > 0;
         std::string answer = "";
-        if ((options.method == "noc-even" && engine.solutions) ||
-            (options.method != "noc-even" && !engine.solutions) ) {
+        if ((options.method == "noc-even" && found) ||
+            (options.method != "noc-even" && !found) ) {
             answer = "EVEN";
         } else {
             answer = "ODD";
@@ -294,9 +406,10 @@ int main(int argc, char *argv[])
 
         if (options.printTime>=0 || options.printVerbose) {
             std::cout   << answer;
+            if (strategies >= 0) std::cout << " (" << strategies << " strategies)";
         }
 
-        if (options.printSolution || options.printVerbose) {
+        if ((options.printSolution || options.printVerbose) && strategies < 0) {
             std::cout << "\n----------\n";
             std::cout << "\n" << ss.str();
         }
@@ -305,6 +418,7 @@ int main(int argc, char *argv[])
 
         if (options.printStatistics || options.printVerbose) {
             engine.printStats();
+            model->statistics();
         }
         
         delete model;
@@ -318,8 +432,7 @@ int main(int argc, char *argv[])
     #ifdef HAS_GECODE
         startClock(); //.............................................
         Gecode::NocModel* model = new Gecode::NocModel(
-                            *game, winConditions,
-                            options.method=="noc-even"?EVEN:ODD);
+                            *game, winConditions, nocOptions);
 
         double preptime = stopClock(); //............................
 
@@ -331,6 +444,7 @@ int main(int argc, char *argv[])
         }
 
         startClock(); //.............................................
+        // Default options, so one thread: all spaces share the NOC buffers.
         Gecode::DFS<Gecode::NocModel> dfs(model);
         delete model;
         Gecode::NocModel* solution = dfs.next();
@@ -392,8 +506,7 @@ int main(int argc, char *argv[])
     #ifdef HAS_CADICAL
         startClock(); //.............................................
         CaDiCaL::NOCModel* model = new CaDiCaL::NOCModel(
-                            *game, winConditions,
-                            options.method=="noc-even"?EVEN:ODD);
+                            *game, winConditions, nocOptions);
 
         double preptime = stopClock(); //............................
 
@@ -454,6 +567,119 @@ int main(int argc, char *argv[])
 
     }
 
+    //-------------------------------------------------------------------------
+    // MPG-Search
+
+    else if (options.method=="mpg-search") {
+        so.nof_solutions = 1;
+        so.print_sol = false;
+
+        double value = 0;
+        bool solution = false;
+        int64_t calls = 0;
+        std::string witness = "";
+
+        startClock(); //.............................................
+        ChuffedBool::NOCModel* chuffedModel = nullptr;
+    #ifdef HAS_CADICAL
+        CaDiCaL::NOCModel* cadicalModel = nullptr;
+    #endif
+        if (options.solver=="chuffed-bool") {
+            chuffedModel = new ChuffedBool::NOCModel(
+                            *game, winConditions, nocOptions);
+        }
+    #ifdef HAS_CADICAL
+        else if (options.solver=="cadical") {
+            cadicalModel = new CaDiCaL::NOCModel(
+                            *game, winConditions, nocOptions);
+        }
+    #endif
+        else {
+            std::cout   << "Error: --mpg-search supports --chuffed-bool"
+                        << " and --cadical only\n";
+            return 0;
+        }
+        double preptime = stopClock(); //............................
+
+        if (options.printTime>1 || options.printVerbose) {
+            std::cout << "Init time          : " << preptime << std::endl;
+        }
+        else if (options.printTime<-1) {
+            std::cout   << preptime << " " << std::flush;
+        }
+
+        std::streambuf* old_buf = std::cout.rdbuf();
+        std::stringstream ss;
+        std::cout.rdbuf(ss.rdbuf());
+
+        startClock(); //.............................................
+        if (chuffedModel) {
+            solution = chuffedModel->searchMeanPayoff(value);
+            calls = chuffedModel->solverCalls;
+            witness = chuffedModel->getWitness();
+        }
+    #ifdef HAS_CADICAL
+        if (cadicalModel) {
+            solution = cadicalModel->searchMeanPayoff(value);
+            calls = cadicalModel->solverCalls;
+            witness = cadicalModel->getWitness();
+        }
+    #endif
+        double totaltime = stopClock(); //...........................
+
+        std::cout.rdbuf(old_buf);
+
+        if (options.printTime>1 || options.printVerbose) {
+            std::cout << "Solving time       : " << totaltime << std::endl;
+        }
+        else if (options.printTime<0) {
+            std::cout   << totaltime << " " << std::flush;
+        }
+
+        if (options.printTime == 1) {
+            std::cout   << totaltime << " " << std::flush;
+        } else if (options.printTime == 2 || options.printVerbose) {
+            std::cout << "Result             : ";
+        }
+
+        if (options.printTime>=0 || options.printVerbose) {
+            if (solution) {
+                int64_t p, q;       // the value is a multiple of p/q
+                decimalFraction(options.precisionMPG, p, q);
+                int digits = std::llround(std::log10(q));
+                std::cout   << std::fixed << std::setprecision(digits)
+                            << value << std::defaultfloat;
+            }
+            else {
+                std::cout << "ODD";
+            }
+            std::cout << " (" << calls << " solver calls)";
+        }
+
+        if ((options.printSolution || options.printVerbose) && solution) {
+            std::cout << "\n----------\n";
+            std::cout << "\n" << witness;
+        }
+
+        std::cout << std::endl;
+
+        if (options.printStatistics || options.printVerbose) {
+            std::cout << "Solver calls       : " << calls << std::endl;
+            if (chuffedModel) {
+                engine.printStats();
+                chuffedModel->statistics();
+            }
+    #ifdef HAS_CADICAL
+            if (cadicalModel) cadicalModel->statistics();
+    #endif
+        }
+
+        delete chuffedModel;
+    #ifdef HAS_CADICAL
+        delete cadicalModel;
+    #endif
+    }
+
     //-------------------------------------------------------------------------
     // SAT Encoding
 
@@ -483,54 +709,196 @@ int main(int argc, char *argv[])
         Zielonka zlk(*game);
         double preptime = stopClock(); //............................
 
-        if (options.printTime>1 || options.printVerbose) {
-            std::cout << "Init time          : " << preptime << std::endl;
+        printInitTime(preptime);
+
+        startClock(); //.............................................
+        auto win = zlk.solve();
+        double totaltime = stopClock(); //...........................
+
+        printSolvingTime(totaltime);
+
+        printWinners(win);
+    }
+
+    //-------------------------------------------------------------------------
+    // FPI
+
+    else if (options.method=="fpi") {
+
+        startClock(); //.............................................
+        FPI fpi(*game, options.threads);
+        double preptime = stopClock(); //............................
+
+        printInitTime(preptime);
+
+        startClock(); //.............................................
+        auto win = fpi.solve();
+        double totaltime = stopClock(); //...........................
+
+        printSolvingTime(totaltime);
+
+        printWinners(win);
+
+        if (options.printStatistics || options.printVerbose) {
+            std::cout << "Block sweeps       : " << fpi.sweeps << std::endl;
+            std::cout << "Level resets       : " << fpi.resets << std::endl;
         }
-        else if (options.printTime<-1) {
-            std::cout   << preptime << " " << std::flush;
+    }
+
+    //-------------------------------------------------------------------------
+    // EPM
+
+    else if (options.method=="epm") {
+
+        if (options.energyCond && options.meanpayoffCond) {
+            std::cout << "Error: --epm solves either --energy or --mean-payoff"
+                      << ", not both.\n";
+            delete game;
+            return 0;
+        }
+        if (options.meanpayoffCond && options.initialCredit>=0) {
+            std::cout << "Error: --credit applies to --epm --energy only.\n";
+            delete game;
+            return 0;
+        }
+        if (options.energyCond && options.thresholdEnergy != 0) {
+            std::cout << "Error: --epm solves --energy with threshold 0"
+                      << "; use --credit for an initial credit.\n";
+            delete game;
+            return 0;
         }
 
         startClock(); //.............................................
-        auto win = zlk.solve();
+        EnergyPM* epm = nullptr;
+        try {
+            if (options.meanpayoffCond) {
+                epm = new EnergyPM(*game, options.thresholdMPG);
+            } else {
+                epm = new EnergyPM(*game);
+            }
+        } catch (const std::overflow_error& e) {
+            std::cout << "Error: " << e.what() << std::endl;
+            delete game;
+            return 0;
+        }
+        double preptime = stopClock(); //............................
+
+        printInitTime(preptime);
+
+        startClock(); //.............................................
+        auto& credit = epm->solve();
         double totaltime = stopClock(); //...........................
 
-        if (options.printTime>1 || options.printVerbose) {
-            std::cout << "Solving time       : " << totaltime << std::endl;
-            // std::cout << "Mem used           : " << memUsed() << std::endl;
+        printSolvingTime(totaltime);
+
+        // With --credit, EVEN starts with that credit; otherwise any
+        // finite credit is enough.
+        auto win = (options.initialCredit >= 0)
+                 ? epm->winners(options.initialCredit)
+                 : epm->winners();
+
+        printWinners(win);
+
+        if (options.printSolution || options.printVerbose) {
+            std::cout << "CREDIT {";
+            for (int32_t v=0; v<game->nvertices; v++) {
+                std::cout << v << ":";
+                if (credit[v] == EnergyPM::TOP) std::cout << "inf";
+                else std::cout << credit[v];
+                if (v<game->nvertices-1) std::cout << ",";
+            }
+            std::cout << "}" <<std::endl;
         }
-        else if (options.printTime<0) {
-            std::cout   << totaltime << " " << std::flush;
+
+        if (options.printStatistics || options.printVerbose) {
+            std::cout << "Credit bound       : " << epm->getBound() << std::endl;
+            std::cout << "Lifts              : " << epm->lifts << std::endl;
         }
 
-        if (options.printTime == 1) {
-            std::cout   << totaltime << " " << std::flush;
+        delete epm;
+    }
+
+    //-------------------------------------------------------------------------
+    // EPG
+
+    else if (options.method=="epg") {
+
+        startClock(); //.............................................
+        EnergyParity epg(*game);
+        double preptime = stopClock(); //............................
+
+        printInitTime(preptime);
+
+        std::array<std::vector<int>,2> win;
+        startClock(); //.............................................
+        try {
+            win = epg.solve();
+        } catch (const std::overflow_error& e) {
+            std::cout << "Error: " << e.what() << std::endl;
+            delete game;
+            return 0;
         }
+        double totaltime = stopClock(); //...........................
 
-        for (size_t i=0; i<options.init.size(); i++) {
-            int32_t v0 = options.init[i];
-            auto it = std::find(win[0].begin(), win[0].end(), v0);
+        printSolvingTime(totaltime);
 
-            if (options.printTime>=0 || options.printVerbose)
-                std::cout << v0 << ": " << (it != win[0].end()?"EVEN ":"ODD ");
-            
-            std::cout << std::endl;        
+        printWinners(win);
+
+        if (options.printStatistics || options.printVerbose) {
+            std::cout << "Energy games       : " << epg.gfeSolves << std::endl;
+            std::cout << "Lifts              : " << epg.lifts << std::endl;
+        }
+    }
+
+    //-------------------------------------------------------------------------
+    // MPG-Values
+
+    else if (options.method=="mpg-values") {
+
+        startClock(); //.............................................
+        MeanPayoffSI* mpg = nullptr;
+        try {
+            mpg = new MeanPayoffSI(*game, options.threads);
+        } catch (const std::invalid_argument& e) {
+            std::cout << "Error: " << e.what() << std::endl;
+            delete game;
+            return 0;
         }
+        double preptime = stopClock(); //............................
+
+        printInitTime(preptime);
+
+        startClock(); //.............................................
+        mpg->solve();
+        double totaltime = stopClock(); //...........................
+
+        printSolvingTime(totaltime);
+
+        auto& values = mpg->getValues();
+        auto& strategy = mpg->getStrategy();
+
+        printInitial([&](int32_t v0) { return values[v0].str(); });
 
         if (options.printSolution || options.printVerbose) {
-            std::cout << "EVEN {";
-            for (int i = 0; i < win[0].size(); i++) {
-                std::cout << win[0][i];
-                if (i<win[0].size()-1) std::cout << ",";
+            std::cout << "VALUES   {";
+            for (int32_t v=0; v<game->nvertices; v++) {
+                std::cout << v << ":" << values[v].str();
+                if (v<game->nvertices-1) std::cout << ",";
             }
-            std::cout << "}\nODD  {";
-            for (int i = 0; i < win[1].size(); i++) {
-                std::cout << win[1][i];
-                if (i<win[1].size()-1) std::cout << ",";
+            std::cout << "}\nSTRATEGY {";
+            for (int32_t v=0; v<game->nvertices; v++) {
+                std::cout << v << "->" << game->targets[strategy[v]];
+                if (v<game->nvertices-1) std::cout << ",";
             }
             std::cout << "}" <<std::endl;
         }
 
+        if (options.printStatistics || options.printVerbose) {
+            std::cout << "Outer iterations   : " << mpg->outerIterations << std::endl;
+            std::cout << "Inner iterations   : " << mpg->innerIterations << std::endl;
+        }
 
+        delete mpg;
     }
 
     //-------------------------------------------------------------------------
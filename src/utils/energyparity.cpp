@@ -0,0 +1,151 @@
+/*
+ * Main authors:
+ *    Gonzalo Hernandez <gonzalo.hernandez@monash>
+ *    <gonzalo.hernandez@udenar.edu.co>
+ *
+ * Contributing authors:
+ *    Guido Tack <guido.tack@monash.edu>
+ *    Julian Gutierrez <J.Gutierrez@sussex.ac.uk>
+ *
+ * This file is part of NOCQ (a CP Toolchain for parity games with quantitative
+ * conditions). This file is based on the recursive algorithm of Chatterjee and
+ * Doyen, "Energy parity games".
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public License,
+ * v. 2.0. If a copy of the MPL was not distributed with this file, You can get
+ * one at https://mozilla.org/MPL/2.0/.
+ *
+ *-----------------------------------------------------------------------------
+ */
+#include "energyparity.h"
+
+#include <algorithm>
+#include <memory>
+#include <stdexcept>
+
+EnergyParity::EnergyParity(Game& g) : g(g), zlk(g) {
+}
+
+//-----------------------------------------------------------------------------
+// Vertices of the subgame where EVEN is not good-for-energy. Priorities are
+// compressed to alternating ranks and vertex v gets the bonus
+// (+/-) (n+1)^rank(v), positive for even priorities. Weights are scaled above
+// the bonus of any simple cycle, so a scaled cycle weight has the sign of the
+// original one, or the sign of its best priority when the original is zero.
+
+std::vector<int> EnergyParity::notGoodForEnergy(bool* removed) {
+    std::vector<bool> alive(g.nvertices);
+    std::vector<int64_t> prios;
+    int64_t n = 0;
+    for (int32_t v=0; v<g.nvertices; v++) {
+        alive[v] = !removed[v];
+        if (!alive[v]) continue;
+        prios.push_back(g.priors[v]);
+        n++;
+    }
+    std::sort(prios.begin(), prios.end(), [&](int64_t a, int64_t b) {
+        return g.isBetter(b,a);
+    });
+    prios.erase(std::unique(prios.begin(), prios.end()), prios.end());
+
+    const __int128 limit = EnergyLifting<__int128>::TOP/4;
+    auto overflow = []() {
+        throw std::overflow_error(
+            "EnergyParity: too many priorities for good-for-energy weights");
+    };
+
+    std::vector<__int128> power(1,1);
+    std::vector<int64_t> rank(prios.size(),0);
+    for (size_t i=1; i<prios.size(); i++) {
+        rank[i] = rank[i-1];
+        if (prios[i]%2 != prios[i-1]%2) {
+            if (power.back() > limit/(n+1)) overflow();
+            power.push_back(power.back()*(n+1));
+            rank[i]++;
+        }
+    }
+    if (power.back() > (limit-1)/n) overflow();
+    __int128 scale = n*power.back()+1;
+
+    std::vector<__int128> bonus(g.nvertices,0);
+    for (int32_t v=0; v<g.nvertices; v++) {
+        if (!alive[v]) continue;
+        size_t i = std::lower_bound(prios.begin(), prios.end(), g.priors[v],
+                        [&](int64_t a, int64_t b) { return g.isBetter(b,a); })
+                 - prios.begin();
+        bonus[v] = g.priors[v]%2 == EVEN ? power[rank[i]] : -power[rank[i]];
+    }
+
+    // The credit bound adds up to one weight per vertex.
+    __int128 room = (limit/n-power.back())/scale;
+    std::vector<__int128> weight(g.nedges,0);
+    for (int32_t e=0; e<g.nedges; e++) {
+        int32_t u = g.sources[e];
+        if (!alive[u] || !alive[g.targets[e]]) continue;
+        __int128 w = g.weights[e];
+        if (w > room || -w > room) overflow();
+        weight[e] = w*scale + bonus[u];
+    }
+
+    EnergyLifting<__int128> gfe(g, weight, &alive);
+    const std::vector<__int128>& c = gfe.solve();
+    gfeSolves++;
+    lifts += gfe.lifts;
+
+    std::vector<int> bad;
+    for (int32_t v=0; v<g.nvertices; v++) {
+        if (alive[v] && c[v] == EnergyLifting<__int128>::TOP) bad.push_back(v);
+    }
+    return bad;
+}
+
+//-----------------------------------------------------------------------------
+
+std::array<std::vector<int>,2> EnergyParity::search(bool* removed) {
+    std::vector<int> A = zlk.getBestVertices(removed);
+    if (A.size() == 0) {
+        return { std::vector<int>(), std::vector<int>() };
+    }
+    int player = g.priors[A[0]] % 2;
+
+    if (player == EVEN) {
+        std::vector<int> B = notGoodForEnergy(removed);
+        if (B.size()) {
+            std::unique_ptr<bool[]> removed2
+                = std::make_unique<bool[]>(g.nvertices);
+            std::copy_n(removed, g.nvertices, removed2.get());
+            zlk.attractor(ODD, B, removed2.get());
+            auto win2 = search(removed2.get());
+            win2[ODD].insert(win2[ODD].end(), B.begin(), B.end());
+            return win2;
+        }
+    }
+
+    std::unique_ptr<bool[]> removed1 = std::make_unique<bool[]>(g.nvertices);
+    std::copy_n(removed, g.nvertices, removed1.get());
+
+    zlk.attractor(player, A, removed1.get());
+    auto win1 = search(removed1.get());
+    if (!win1[1-player].size()) {
+        win1[player].insert(win1[player].end(), A.begin(), A.end());
+        return win1;
+    }
+    else {
+        std::unique_ptr<bool[]> removed2
+            = std::make_unique<bool[]>(g.nvertices);
+        std::copy_n(removed, g.nvertices, removed2.get());
+        std::vector<int> B(win1[1-player]);
+        zlk.attractor(1-player, B, removed2.get());
+        auto win2 = search(removed2.get());
+        win2[1-player].insert(win2[1-player].end(), B.begin(), B.end());
+        return win2;
+    }
+}
+
+//-----------------------------------------------------------------------------
+
+std::array<std::vector<int>,2> EnergyParity::solve() {
+    std::unique_ptr<bool[]> removed = std::make_unique<bool[]>(g.nvertices);
+    std::fill_n(removed.get(), g.nvertices, false);
+    return search(removed.get());
+}
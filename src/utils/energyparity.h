@@ -0,0 +1,59 @@
+/*
+ * Main authors:
+ *    Gonzalo Hernandez <gonzalo.hernandez@monash>
+ *    <gonzalo.hernandez@udenar.edu.co>
+ *
+ * Contributing authors:
+ *    Guido Tack <guido.tack@monash.edu>
+ *    Julian Gutierrez <J.Gutierrez@sussex.ac.uk>
+ *
+ * This file is part of NOCQ (a CP Toolchain for parity games with quantitative
+ * conditions). This file is based on the recursive algorithm of Chatterjee and
+ * Doyen, "Energy parity games".
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public License,
+ * v. 2.0. If a copy of the MPL was not distributed with this file, You can get
+ * one at https://mozilla.org/MPL/2.0/.
+ *
+ *-----------------------------------------------------------------------------
+ */
+#ifndef ENERGYPARITY_H
+#define ENERGYPARITY_H
+
+#ifndef GAME_H
+#include "game.h"
+#endif
+
+#include "zielonka.h"
+#include "epm.h"
+
+#include <array>
+#include <vector>
+#include <cstdint>
+
+//-----------------------------------------------------------------------------
+// EVEN wins a play when the parity condition holds and the energy level never
+// drops below zero, for some finite initial credit.
+//
+// Zielonka's recursion, except that when the best priority is even EVEN must
+// first be good-for-energy everywhere: able to make every cycle either
+// positive, or of weight zero with an even best priority. Good-for-energy is
+// an energy game on weights scaled above a priority bonus.
+
+class EnergyParity {
+private:
+    Game& g;
+    Zielonka zlk;
+
+    std::vector<int> notGoodForEnergy(bool* removed);
+    std::array<std::vector<int>,2> search(bool* removed);
+public:
+    int64_t gfeSolves = 0;
+    int64_t lifts = 0;
+
+    EnergyParity(Game& g);
+
+    std::array<std::vector<int>,2> solve();
+};
+
+#endif // ENERGYPARITY_H
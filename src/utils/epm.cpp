@@ -0,0 +1,213 @@
+/*
+ * Main authors:
+ *    Gonzalo Hernandez <gonzalo.hernandez@monash>
+ *    <gonzalo.hernandez@udenar.edu.co>
+ *
+ * Contributing authors:
+ *    Guido Tack <guido.tack@monash.edu>
+ *    Julian Gutierrez <J.Gutierrez@sussex.ac.uk>
+ *
+ * This file is part of NOCQ (a CP Toolchain for parity games with quantitative
+ * conditions). This file is based on the energy progress measures of Brim,
+ * Chaloupka, Doyen, Gentilini and Raskin, "Faster algorithms for mean-payoff
+ * games".
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public License,
+ * v. 2.0. If a copy of the MPL was not distributed with this file, You can get
+ * one at https://mozilla.org/MPL/2.0/.
+ *
+ *-----------------------------------------------------------------------------
+ */
+#include "epm.h"
+
+#include <algorithm>
+#include <deque>
+#include <stdexcept>
+
+template <typename T>
+EnergyLifting<T>::EnergyLifting(Game& g, const std::vector<T>& weight,
+                                const std::vector<bool>* alive,
+                                const std::vector<bool>* usable)
+:   g(g), weight(weight), alive(alive), usable(usable)
+{
+    // Any finite minimal credit is at most the sum, over all vertices, of
+    // the most negative outgoing weight: a play that needs more must repeat
+    // a vertex with a negative cycle in between, and EVEN loses it anyway.
+    // Taken over every edge, so it still holds for any 'usable' subset.
+    const T limit = TOP/4;
+    for (int32_t v=0; v<g.nvertices; v++) {
+        if (!isAlive(v)) continue;
+        T worst = 0;
+        for (size_t j=0; j<g.outs[v].size(); j++) {
+            int32_t e = g.outs[v][j];
+            if (!isAlive(g.targets[e])) continue;
+            if (weight[e] > limit || weight[e] < -limit) {
+                throw std::overflow_error("EnergyPM: weight out of range");
+            }
+            if (weight[e] < worst) worst = weight[e];
+        }
+        if (-worst > limit-bound) {
+            throw std::overflow_error("EnergyPM: credit bound out of range");
+        }
+        bound -= worst;
+    }
+}
+
+//-----------------------------------------------------------------------------
+// Credit needed at the source of e to take e and continue from its target.
+
+template <typename T>
+T EnergyLifting<T>::need(int32_t e) const {
+    T c = credit[g.targets[e]];
+    if (c == TOP) return TOP;
+    T n = c-weight[e];
+    if (n < 0) return 0;
+    return n > bound ? TOP : n;
+}
+
+//-----------------------------------------------------------------------------
+
+template <typename T>
+T EnergyLifting<T>::lift(int32_t v) const {
+    bool even = g.owners[v] == EVEN;
+    T best = even ? TOP : 0;
+    for (size_t j=0; j<g.outs[v].size(); j++) {
+        int32_t e = g.outs[v][j];
+        if (!isUsable(e)) continue;
+        T n = need(e);
+        if (even && n < best) best = n;
+        if (!even && n > best) best = n;
+    }
+    return best;
+}
+
+//-----------------------------------------------------------------------------
+// Worklist lifting. An EVEN vertex is only re-queued when its last consistent
+// successor goes, which 'count' tracks; an ODD vertex as soon as any of its
+// successors asks for more than it currently has.
+
+template <typename T>
+const std::vector<T>& EnergyLifting<T>::solve(const std::vector<T>* from) {
+    if (from) credit = *from;
+    else credit.assign(g.nvertices, 0);
+    count.assign(g.nvertices, 0);
+    std::vector<bool> queued(g.nvertices, false);
+    std::deque<int32_t> work;
+
+    for (int32_t v=0; v<g.nvertices; v++) {
+        if (!isAlive(v)) continue;
+        bool consistent = g.owners[v] != EVEN;
+        for (size_t j=0; j<g.outs[v].size(); j++) {
+            int32_t e = g.outs[v][j];
+            if (!isUsable(e)) continue;
+            bool ok = need(e) <= credit[v];
+            if (g.owners[v] == EVEN) {
+                if (ok) count[v]++;
+                consistent |= ok;
+            }
+            else {
+                consistent &= ok;
+            }
+        }
+        if (!consistent) {
+            work.push_back(v);
+            queued[v] = true;
+        }
+    }
+
+    while (!work.empty()) {
+        int32_t v = work.front();
+        work.pop_front();
+        queued[v] = false;
+
+        T old = credit[v];
+        T val = lift(v);
+        if (val <= old) continue;
+
+        credit[v] = val;
+        lifts++;
+
+        if (g.owners[v] == EVEN) {
+            count[v] = 0;
+            for (size_t j=0; j<g.outs[v].size(); j++) {
+                int32_t e = g.outs[v][j];
+                if (isUsable(e) && need(e) <= val) count[v]++;
+            }
+        }
+
+        for (size_t j=0; j<g.ins[v].size(); j++) {
+            int32_t e = g.ins[v][j];
+            int32_t u = g.sources[e];
+            if (!isAlive(u) || queued[u] || credit[u] == TOP) continue;
+            if (usable && !(*usable)[e]) continue;
+
+            T now = need(e);
+            if (now <= credit[u]) continue;
+
+            if (g.owners[u] == EVEN) {
+                T before = std::max<T>(0, old-weight[e]);
+                if (before > credit[u] || --count[u] > 0) continue;
+            }
+            work.push_back(u);
+            queued[u] = true;
+        }
+    }
+    return credit;
+}
+
+template class EnergyLifting<int64_t>;
+template class EnergyLifting<__int128>;
+
+//=============================================================================
+
+EnergyPM::EnergyPM(Game& g) : g(g) {
+    shiftWeights();
+}
+
+//-----------------------------------------------------------------------------
+
+EnergyPM::EnergyPM(Game& g, double threshold) : g(g) {
+    decimalFraction(threshold, p, q);
+    shiftWeights();
+}
+
+EnergyPM::~EnergyPM() {
+    delete lifting;
+}
+
+//-----------------------------------------------------------------------------
+
+void EnergyPM::shiftWeights() {
+    const __int128 limit = INT64_MAX/4;
+    weight.resize(g.nedges);
+    for (int32_t e=0; e<g.nedges; e++) {
+        __int128 w = (__int128)q*g.weights[e]-p;
+        if (w > limit || -w > limit) {
+            throw std::overflow_error("EnergyPM: weight out of range");
+        }
+        weight[e] = static_cast<int64_t>(w);
+    }
+    lifting = new EnergyLifting<int64_t>(g, weight);
+}
+
+//-----------------------------------------------------------------------------
+
+const std::vector<int64_t>& EnergyPM::solve() {
+    const std::vector<int64_t>& credit = lifting->solve();
+    lifts = lifting->lifts;
+    return credit;
+}
+
+//-----------------------------------------------------------------------------
+// EVEN wins from v when its minimal credit does not exceed initialCredit. The
+// default asks for any finite credit, i.e. the plain energy winning region.
+
+std::array<std::vector<int>,2> EnergyPM::winners(int64_t initialCredit) const {
+    const std::vector<int64_t>& credit = lifting->getCredits();
+    std::array<std::vector<int>,2> win;
+    for (int32_t v=0; v<g.nvertices; v++) {
+        bool even = credit[v] < TOP && credit[v] <= initialCredit;
+        win[even ? EVEN : ODD].push_back(v);
+    }
+    return win;
+}
@@ -0,0 +1,110 @@
+/*
+ * Main authors:
+ *    Gonzalo Hernandez <gonzalo.hernandez@monash>
+ *    <gonzalo.hernandez@udenar.edu.co>
+ *
+ * Contributing authors:
+ *    Guido Tack <guido.tack@monash.edu>
+ *    Julian Gutierrez <J.Gutierrez@sussex.ac.uk>
+ *
+ * This file is part of NOCQ (a CP Toolchain for parity games with quantitative
+ * conditions). This file is based on the energy progress measures of Brim,
+ * Chaloupka, Doyen, Gentilini and Raskin, "Faster algorithms for mean-payoff
+ * games".
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public License,
+ * v. 2.0. If a copy of the MPL was not distributed with this file, You can get
+ * one at https://mozilla.org/MPL/2.0/.
+ *
+ *-----------------------------------------------------------------------------
+ */
+#ifndef EPM_H
+#define EPM_H
+
+#ifndef GAME_H
+#include "game.h"
+#endif
+
+#include <array>
+#include <vector>
+#include <cstdint>
+
+//-----------------------------------------------------------------------------
+// Worklist lifting of an energy progress measure over an arbitrary edge
+// weighting. Vertices outside 'alive' (when given) are ignored together with
+// the edges leading to them, so subgames can be solved in place; so are the
+// edges outside 'usable', which may change between calls to solve(). A solve
+// can start from any measure below the least one, e.g. that of a game with
+// more EVEN edges. Instantiated for int64_t and for __int128, the latter for
+// engines that scale weights.
+
+template <typename T>
+class EnergyLifting {
+private:
+    Game& g;
+    const std::vector<T>& weight;       // one per edge
+    const std::vector<bool>* alive;
+    const std::vector<bool>* usable;    // one per edge
+    T bound = 0;                        // credits above bound are TOP
+
+    std::vector<T> credit;
+    std::vector<int32_t> count;         // EVEN: successors still consistent
+
+    bool isAlive(int32_t v) const { return !alive || (*alive)[v]; }
+    bool isUsable(int32_t e) const {
+        return (!usable || (*usable)[e]) && isAlive(g.targets[e]);
+    }
+    T need(int32_t e) const;
+    T lift(int32_t v) const;
+public:
+    static constexpr T TOP = (((T(1) << (sizeof(T)*8-2)) - 1) << 1) + 1;
+
+    int64_t lifts = 0;
+
+    EnergyLifting(Game& g, const std::vector<T>& weight,
+                  const std::vector<bool>* alive=nullptr,
+                  const std::vector<bool>* usable=nullptr);
+
+    T getBound() const { return bound; }
+    const std::vector<T>& getCredits() const { return credit; }
+    const std::vector<T>& solve(const std::vector<T>* from=nullptr);
+};
+
+extern template class EnergyLifting<int64_t>;
+extern template class EnergyLifting<__int128>;
+
+//-----------------------------------------------------------------------------
+// Minimal initial credit EVEN needs, from every vertex, to keep the energy
+// level (running sum of edge weights) non-negative forever. A credit equal to
+// EnergyPM::TOP means ODD wins the energy game from that vertex.
+//
+// Weights are shifted to q*w-p when a mean-payoff threshold p/q is given, so
+// that "finite credit" reads as "EVEN ensures mean-payoff >= p/q".
+
+class EnergyPM {
+private:
+    Game& g;
+    int64_t p = 0;                      // mean-payoff shift numerator
+    int64_t q = 1;                      // mean-payoff shift denominator
+
+    std::vector<int64_t> weight;
+    EnergyLifting<int64_t>* lifting = nullptr;
+
+    void shiftWeights();
+public:
+    static constexpr int64_t TOP = EnergyLifting<int64_t>::TOP;
+
+    int64_t lifts = 0;
+
+    EnergyPM(Game& g);
+    EnergyPM(Game& g, double threshold);
+    ~EnergyPM();
+    EnergyPM(const EnergyPM&) = delete;
+    EnergyPM& operator=(const EnergyPM&) = delete;
+
+    int64_t getBound() const { return lifting->getBound(); }
+    const std::vector<int64_t>& solve();
+    std::array<std::vector<int>,2> winners(int64_t initialCredit=TOP-1) const;
+};
+
+#endif // EPM_H
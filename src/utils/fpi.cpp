@@ -0,0 +1,125 @@
+/*
+ * Main authors:
+ *    Gonzalo Hernandez <gonzalo.hernandez@monash>
+ *    <gonzalo.hernandez@udenar.edu.co>
+ *
+ * Contributing authors:
+ *    Guido Tack <guido.tack@monash.edu>
+ *    Julian Gutierrez <J.Gutierrez@sussex.ac.uk>
+ *
+ * This file is part of NOCQ (a CP Toolchain for parity games with quantitative
+ * conditions). This file is based on the distraction fixpoint iteration of
+ * Bruse, Falk and Lange, "The Fixpoint-Iteration Algorithm for Parity Games".
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public License,
+ * v. 2.0. If a copy of the MPL was not distributed with this file, You can get
+ * one at https://mozilla.org/MPL/2.0/.
+ *
+ *-----------------------------------------------------------------------------
+ */
+#include "fpi.h"
+#include "parallel.h"
+
+FPI::FPI(Game& g, int nthreads)
+:   g(g), nthreads(resolveThreads(nthreads)), distraction(g.nvertices,0)
+{
+    buildBlocks();
+}
+
+//-----------------------------------------------------------------------------
+// Vertices are grouped by priority, least significant block first (lowest
+// priority for MAX, highest for MIN), so that "every block below b" is the
+// contiguous prefix order[0..blockStart[b]).
+
+void FPI::buildBlocks() {
+    order.resize(g.nvertices);
+    for (int32_t v=0; v<g.nvertices; v++) order[v] = v;
+
+    std::sort(order.begin(), order.end(), [&](int32_t a, int32_t b) {
+        if (g.priors[a] == g.priors[b]) return a < b;
+        return g.isBetter(g.priors[b], g.priors[a]);
+    });
+
+    blockStart.clear();
+    for (int32_t i=0; i<g.nvertices; i++) {
+        if (i==0 || g.priors[order[i]] != g.priors[order[i-1]]) {
+            blockStart.push_back(i);
+        }
+    }
+    blockStart.push_back(g.nvertices);
+}
+
+//-----------------------------------------------------------------------------
+// Recompute the one-step winner of every undistracted vertex in block b. A
+// vertex u is currently won by the parity of its priority, unless it is
+// distracted. The new distractions are collected per chunk and only applied
+// once the whole block has been read, so the sweep does not depend on the
+// order in which threads run.
+
+bool FPI::sweepBlock(int32_t b, std::vector<std::vector<int32_t>>& found) {
+    int64_t lo = blockStart[b];
+    int64_t hi = blockStart[b+1];
+    int parity = g.priors[order[lo]] % 2;
+
+    for (auto& f : found) f.clear();
+
+    parallelChunks(lo, hi, nthreads, [&](int64_t c, int64_t from, int64_t to) {
+        std::vector<int32_t>& mine = found[c];
+        for (int64_t i=from; i<to; i++) {
+            int32_t v = order[i];
+            if (distraction[v]) continue;
+
+            bool ally = g.owners[v] == parity;
+            bool keeps = !ally;
+            for (size_t j=0; j<g.outs[v].size(); j++) {
+                int32_t w = g.targets[g.outs[v][j]];
+                bool good = (g.priors[w] % 2 ^ distraction[w]) == parity;
+                if (ally && good)   { keeps = true;  break; }
+                if (!ally && !good) { keeps = false; break; }
+            }
+            if (!keeps) mine.push_back(v);
+        }
+    });
+
+    bool changed = false;
+    for (auto& f : found) {
+        for (int32_t v : f) distraction[v] = 1;
+        changed |= !f.empty();
+    }
+    sweeps++;
+    return changed;
+}
+
+//-----------------------------------------------------------------------------
+
+void FPI::resetBelow(int32_t b) {
+    parallelChunks(0, blockStart[b], nthreads,
+        [&](int64_t, int64_t from, int64_t to) {
+            for (int64_t i=from; i<to; i++) distraction[order[i]] = 0;
+        });
+    resets++;
+}
+
+//-----------------------------------------------------------------------------
+
+std::array<std::vector<int>,2> FPI::solve() {
+    std::vector<std::vector<int32_t>> found(nthreads);
+    int32_t nblocks = blockStart.size()-1;
+
+    int32_t b = 0;
+    while (b < nblocks) {
+        if (sweepBlock(b, found)) {
+            resetBelow(b);
+            b = 0;
+        }
+        else {
+            b++;
+        }
+    }
+
+    std::array<std::vector<int>,2> win;
+    for (int32_t v=0; v<g.nvertices; v++) {
+        win[g.priors[v] % 2 ^ distraction[v]].push_back(v);
+    }
+    return win;
+}
@@ -0,0 +1,52 @@
+/*
+ * Main authors:
+ *    Gonzalo Hernandez <gonzalo.hernandez@monash>
+ *    <gonzalo.hernandez@udenar.edu.co>
+ *
+ * Contributing authors:
+ *    Guido Tack <guido.tack@monash.edu>
+ *    Julian Gutierrez <J.Gutierrez@sussex.ac.uk>
+ *
+ * This file is part of NOCQ (a CP Toolchain for parity games with quantitative
+ * conditions). This file is based on the distraction fixpoint iteration of
+ * Bruse, Falk and Lange, "The Fixpoint-Iteration Algorithm for Parity Games".
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public License,
+ * v. 2.0. If a copy of the MPL was not distributed with this file, You can get
+ * one at https://mozilla.org/MPL/2.0/.
+ *
+ *-----------------------------------------------------------------------------
+ */
+#ifndef FPI_H
+#define FPI_H
+
+#ifndef GAME_H
+#include "game.h"
+#endif
+
+#include <array>
+#include <vector>
+#include <cstdint>
+
+class FPI {
+private:
+    Game& g;
+    int nthreads;
+
+    std::vector<int32_t> order;         // vertices grouped by priority block
+    std::vector<int32_t> blockStart;    // block b is order[blockStart[b]..]
+    std::vector<uint8_t> distraction;
+
+    void buildBlocks();
+    bool sweepBlock(int32_t b, std::vector<std::vector<int32_t>>& found);
+    void resetBelow(int32_t b);
+public:
+    int64_t sweeps = 0;
+    int64_t resets = 0;
+
+    FPI(Game& g, int nthreads=0);
+
+    std::array<std::vector<int>,2> solve();
+};
+
+#endif // FPI_H
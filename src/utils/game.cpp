@@ -25,6 +25,7 @@
 #include <algorithm>
 #include <random>
 #include <chrono> 
+#include <cmath>
 
 #include "game.h"
 
@@ -36,6 +37,20 @@ parity_type opponent(parity_type PARITY) {
 
 //-----------------------------------------------------------------------------
 
+void decimalFraction(double t, int64_t& p, int64_t& q) {
+    q = 1;
+    for (int k=0; k<=9; k++) {
+        double scaled = t*q;
+        if (std::fabs(scaled-std::round(scaled)) < 1e-9 || k==9) {
+            p = static_cast<int64_t>(std::llround(scaled));
+            return;
+        }
+        q *= 10;
+    }
+}
+
+//-----------------------------------------------------------------------------
+
 void Game::fixZeros() {
     for (size_t i=0; i<sources.size(); i++) {
         sources[i]--;
@@ -38,10 +38,17 @@ enum objective_type {MIN,MAX};                              // 0,1
 enum game_type      {DEF,JURD,RAND,MLADDER,SPRAND,SQNC,     // Game structure
                     DZN,GM,GMW,CHPKA,DIM};                  // Game file format
 enum parity_comp    {BET,EQU,BEQ};
+enum amo_type       {AMO_SEQ,AMO_PRODUCT,AMO_NATIVE};       // At-most-one
+enum branch_type    {BRANCH_SCAN,BRANCH_DFS,BRANCH_ACTIVITY}; // Edge brancher
+enum warm_type      {WARM_NONE,WARM_ZIELONKA,WARM_MPG};     // Warm start
 //-----------------------------------------------------------------------------
 
 parity_type opponent(parity_type PARITY);
 
+// A threshold read as a decimal fraction p/q (q a power of ten, at most 10^9),
+// exact for every value that can be typed in the command line.
+void decimalFraction(double t, int64_t& p, int64_t& q);
+
 //=============================================================================
 
 class Game {
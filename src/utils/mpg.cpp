@@ -0,0 +1,320 @@
+/*
+ * Main authors:
+ *    Gonzalo Hernandez <gonzalo.hernandez@monash>
+ *    <gonzalo.hernandez@udenar.edu.co>
+ *
+ * Contributing authors:
+ *    Guido Tack <guido.tack@monash.edu>
+ *    Julian Gutierrez <J.Gutierrez@sussex.ac.uk>
+ *
+ * This file is part of NOCQ (a CP Toolchain for parity games with quantitative
+ * conditions). This file is based on the policy iteration of Dhingra and
+ * Gaubert, "How to solve large scale deterministic games with mean payoff by
+ * policy iteration", with Howard's multichain evaluation of Cochet-Terrasson
+ * et al. for the one-player games.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public License,
+ * v. 2.0. If a copy of the MPL was not distributed with this file, You can get
+ * one at https://mozilla.org/MPL/2.0/.
+ *
+ *-----------------------------------------------------------------------------
+ */
+#include "mpg.h"
+#include "parallel.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+//=============================================================================
+
+static __int128 gcd128(__int128 a, __int128 b) {
+    if (a < 0) a = -a;
+    if (b < 0) b = -b;
+    while (b != 0) {
+        __int128 t = a % b;
+        a = b;
+        b = t;
+    }
+    return a;
+}
+
+static std::string str128(__int128 x) {
+    if (x == 0) return "0";
+    bool neg = x < 0;
+    std::string s;
+    while (x != 0) {
+        int d = static_cast<int>(x % 10);
+        s.push_back('0' + (neg ? -d : d));
+        x /= 10;
+    }
+    if (neg) s.push_back('-');
+    std::reverse(s.begin(), s.end());
+    return s;
+}
+
+//-----------------------------------------------------------------------------
+
+Rational::Rational(__int128 n, __int128 d) : num(n), den(d) {
+    if (den < 0) { num = -num; den = -den; }
+    __int128 k = gcd128(num, den);
+    if (k > 1) { num /= k; den /= k; }
+}
+
+Rational Rational::operator+(const Rational& o) const {
+    __int128 k = gcd128(den, o.den);
+    return Rational(num*(o.den/k) + o.num*(den/k), den/k*o.den);
+}
+
+Rational Rational::operator-(const Rational& o) const {
+    __int128 k = gcd128(den, o.den);
+    return Rational(num*(o.den/k) - o.num*(den/k), den/k*o.den);
+}
+
+std::string Rational::str() const {
+    if (den == 1) return str128(num);
+    return str128(num) + "/" + str128(den);
+}
+
+//=============================================================================
+
+MeanPayoffSI::MeanPayoffSI(Game& g, int nthreads)
+:   g(g), nthreads(resolveThreads(nthreads)),
+    strategy(g.nvertices,-1), value(g.nvertices), bias(g.nvertices),
+    sccId(g.nvertices,-1), state(g.nvertices,0)
+{
+    // Every play must be infinite for its mean payoff to be defined.
+    for (int32_t v=0; v<g.nvertices; v++) {
+        if (g.outs[v].size() == 0) {
+            throw std::invalid_argument("MeanPayoffSI: dead end at vertex "
+                                        + std::to_string(v));
+        }
+    }
+}
+
+//-----------------------------------------------------------------------------
+// What a vertex would get by moving along e: the value of the target and, in
+// the same value class, the weight of e measured against that value.
+
+std::pair<Rational,Rational> MeanPayoffSI::key(int32_t e) const {
+    int32_t t = g.targets[e];
+    return { value[t], Rational(g.weights[e]) - value[t] + bias[t] };
+}
+
+//-----------------------------------------------------------------------------
+// Tarjan over the graph left when EVEN is bound to its current strategy. SCCs
+// come out sinks first, so the height of an SCC in the condensation is known
+// as soon as it is closed.
+
+void MeanPayoffSI::computeSCCs() {
+    int32_t n = g.nvertices;
+    std::vector<int32_t> index(n,-1), low(n,0), height;
+    std::vector<bool> onStack(n,false);
+    std::vector<int32_t> stack;
+    std::vector<std::pair<int32_t,size_t>> frames;
+    int32_t counter = 0, ncomps = 0;
+
+    std::fill(sccId.begin(), sccId.end(), -1);
+    levels.clear();
+
+    auto degree = [&](int32_t v) -> size_t {
+        return isFixed(v) ? 1 : g.outs[v].size();
+    };
+    auto edge = [&](int32_t v, size_t i) -> int32_t {
+        return isFixed(v) ? strategy[v] : g.outs[v][i];
+    };
+
+    for (int32_t s=0; s<n; s++) {
+        if (index[s] != -1) continue;
+        index[s] = low[s] = counter++;
+        stack.push_back(s); onStack[s] = true;
+        frames.push_back({s,0});
+
+        while (!frames.empty()) {
+            int32_t v = frames.back().first;
+            size_t& i = frames.back().second;
+            if (i < degree(v)) {
+                int32_t w = g.targets[edge(v,i++)];
+                if (index[w] == -1) {
+                    index[w] = low[w] = counter++;
+                    stack.push_back(w); onStack[w] = true;
+                    frames.push_back({w,0});
+                }
+                else if (onStack[w]) {
+                    low[v] = std::min(low[v], index[w]);
+                }
+                continue;
+            }
+
+            frames.pop_back();
+            if (!frames.empty()) {
+                int32_t u = frames.back().first;
+                low[u] = std::min(low[u], low[v]);
+            }
+            if (low[v] != index[v]) continue;
+
+            std::vector<int32_t> comp;
+            int32_t w;
+            do {
+                w = stack.back(); stack.pop_back();
+                onStack[w] = false;
+                sccId[w] = ncomps;
+                comp.push_back(w);
+            } while (w != v);
+
+            int32_t h = 0;
+            for (int32_t u : comp) {
+                for (size_t j=0; j<degree(u); j++) {
+                    int32_t t = g.targets[edge(u,j)];
+                    if (sccId[t] != ncomps) h = std::max(h, height[sccId[t]]+1);
+                }
+            }
+            height.push_back(h);
+            if ((int32_t)levels.size() <= h) levels.resize(h+1);
+            levels[h].push_back(std::move(comp));
+            ncomps++;
+        }
+    }
+}
+
+//-----------------------------------------------------------------------------
+// Value and bias of every vertex of an SCC when both players follow
+// 'strategy'. Each vertex ends either in an already evaluated vertex (maybe in
+// a lower SCC) or in a fresh cycle, whose bias is normalised to sum zero.
+
+void MeanPayoffSI::evaluatePolicy(const std::vector<int32_t>& comp, int32_t id) {
+    for (int32_t v : comp) state[v] = 0;
+
+    std::vector<int32_t> path;
+    for (int32_t s : comp) {
+        if (state[s] != 0) continue;
+
+        path.clear();
+        int32_t u = s;
+        int32_t t;
+        while (true) {
+            state[u] = 1;
+            path.push_back(u);
+            t = g.targets[strategy[u]];
+            if (sccId[t] != id || state[t] != 0) break;
+            u = t;
+        }
+
+        size_t stop = path.size();
+        if (sccId[t] == id && state[t] == 1) {
+            stop = std::find(path.begin(), path.end(), t) - path.begin();
+            __int128 sum = 0;
+            for (size_t i=stop; i<path.size(); i++) {
+                sum += g.weights[strategy[path[i]]];
+            }
+            int64_t length = path.size()-stop;
+            Rational mean(sum, length);
+
+            Rational total;
+            bias[path[stop]] = Rational();
+            for (size_t i=path.size()-1; i>stop; i--) {
+                int32_t next = i+1 < path.size() ? path[i+1] : path[stop];
+                bias[path[i]] = Rational(g.weights[strategy[path[i]]])
+                              - mean + bias[next];
+                total = total + bias[path[i]];
+            }
+            Rational shift(total.num, total.den*length);
+            for (size_t i=stop; i<path.size(); i++) {
+                value[path[i]] = mean;
+                bias[path[i]] = bias[path[i]] - shift;
+                state[path[i]] = 2;
+            }
+        }
+
+        for (size_t i=stop; i-- > 0; ) {
+            int32_t v = path[i];
+            int32_t e = strategy[v];
+            value[v] = value[g.targets[e]];
+            bias[v] = Rational(g.weights[e]) - value[v] + bias[g.targets[e]];
+            state[v] = 2;
+        }
+    }
+}
+
+//-----------------------------------------------------------------------------
+// ODD's best response inside one SCC: Howard's iteration, switching an ODD
+// vertex only to a strictly smaller (value,bias) pair.
+
+int64_t MeanPayoffSI::solveSCC(const std::vector<int32_t>& comp, int32_t id) {
+    int64_t iterations = 0;
+    while (true) {
+        evaluatePolicy(comp, id);
+        iterations++;
+
+        bool changed = false;
+        for (int32_t v : comp) {
+            if (isFixed(v)) continue;
+            int32_t best = strategy[v];
+            auto bestKey = key(best);
+            for (size_t j=0; j<g.outs[v].size(); j++) {
+                int32_t e = g.outs[v][j];
+                auto k = key(e);
+                if (k < bestKey) { best = e; bestKey = k; }
+            }
+            if (best != strategy[v]) {
+                strategy[v] = best;
+                changed = true;
+            }
+        }
+        if (!changed) break;
+    }
+    return iterations;
+}
+
+//-----------------------------------------------------------------------------
+
+bool MeanPayoffSI::improveEven() {
+    std::vector<char> changed(nthreads, 0);
+    parallelChunks(0, g.nvertices, nthreads,
+        [&](int64_t c, int64_t from, int64_t to) {
+            for (int32_t v=from; v<to; v++) {
+                if (!isFixed(v)) continue;
+                int32_t best = strategy[v];
+                auto bestKey = key(best);
+                for (size_t j=0; j<g.outs[v].size(); j++) {
+                    int32_t e = g.outs[v][j];
+                    auto k = key(e);
+                    if (bestKey < k) { best = e; bestKey = k; }
+                }
+                if (best != strategy[v]) {
+                    strategy[v] = best;
+                    changed[c] = 1;
+                }
+            }
+        });
+    return std::find(changed.begin(), changed.end(), 1) != changed.end();
+}
+
+//-----------------------------------------------------------------------------
+
+void MeanPayoffSI::solve() {
+    for (int32_t v=0; v<g.nvertices; v++) {
+        int32_t best = g.outs[v][0];
+        for (size_t j=1; j<g.outs[v].size(); j++) {
+            int32_t e = g.outs[v][j];
+            bool even = g.owners[v] == EVEN;
+            if (even ? g.weights[e] > g.weights[best]
+                     : g.weights[e] < g.weights[best]) best = e;
+        }
+        strategy[v] = best;
+    }
+
+    do {
+        outerIterations++;
+        computeSCCs();
+        for (auto& level : levels) {
+            std::vector<int64_t> iterations(nthreads, 0);
+            parallelChunks(0, level.size(), nthreads,
+                [&](int64_t c, int64_t from, int64_t to) {
+                    for (int64_t i=from; i<to; i++) {
+                        iterations[c] += solveSCC(level[i], sccId[level[i][0]]);
+                    }
+                }, 1);
+            for (int64_t k : iterations) innerIterations += k;
+        }
+    } while (improveEven());
+}
@@ -0,0 +1,94 @@
+/*
+ * Main authors:
+ *    Gonzalo Hernandez <gonzalo.hernandez@monash>
+ *    <gonzalo.hernandez@udenar.edu.co>
+ *
+ * Contributing authors:
+ *    Guido Tack <guido.tack@monash.edu>
+ *    Julian Gutierrez <J.Gutierrez@sussex.ac.uk>
+ *
+ * This file is part of NOCQ (a CP Toolchain for parity games with quantitative
+ * conditions). This file is based on the policy iteration of Dhingra and
+ * Gaubert, "How to solve large scale deterministic games with mean payoff by
+ * policy iteration", with Howard's multichain evaluation of Cochet-Terrasson
+ * et al. for the one-player games.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public License,
+ * v. 2.0. If a copy of the MPL was not distributed with this file, You can get
+ * one at https://mozilla.org/MPL/2.0/.
+ *
+ *-----------------------------------------------------------------------------
+ */
+#ifndef MPG_H
+#define MPG_H
+
+#ifndef GAME_H
+#include "game.h"
+#endif
+
+#include <vector>
+#include <utility>
+#include <string>
+#include <cstdint>
+
+//-----------------------------------------------------------------------------
+// Exact rational with a positive denominator, always kept in lowest terms.
+
+struct Rational {
+    __int128 num = 0;
+    __int128 den = 1;
+
+    Rational() = default;
+    Rational(__int128 n, __int128 d=1);
+
+    Rational operator+(const Rational& o) const;
+    Rational operator-(const Rational& o) const;
+    bool operator==(const Rational& o) const { return num==o.num && den==o.den; }
+    bool operator!=(const Rational& o) const { return !(*this == o); }
+    bool operator<(const Rational& o) const  { return num*o.den < o.num*den; }
+    bool operator>(const Rational& o) const  { return o < *this; }
+
+    std::string str() const;
+};
+
+//-----------------------------------------------------------------------------
+// Optimal mean-payoff value of every vertex (EVEN maximises, ODD minimises
+// the limit average of the weights) and optimal positional strategies.
+//
+// EVEN's strategy is improved against ODD's best response. The best response
+// is the one-player game where EVEN's choices are fixed, solved with Howard's
+// multichain iteration one SCC at a time: SCCs at the same height of the
+// condensation do not depend on each other and are evaluated in parallel.
+
+class MeanPayoffSI {
+private:
+    Game& g;
+    int nthreads;
+
+    std::vector<int32_t>  strategy;     // chosen edge, for both players
+    std::vector<Rational> value;        // cycle mean reached
+    std::vector<Rational> bias;         // potential within a value class
+
+    std::vector<int32_t>  sccId;
+    std::vector<std::vector<std::vector<int32_t>>> levels;
+    std::vector<uint8_t>  state;
+
+    bool isFixed(int32_t v) const { return g.owners[v] == EVEN; }
+    std::pair<Rational,Rational> key(int32_t e) const;
+
+    void computeSCCs();
+    void evaluatePolicy(const std::vector<int32_t>& comp, int32_t id);
+    int64_t solveSCC(const std::vector<int32_t>& comp, int32_t id);
+    bool improveEven();
+public:
+    int64_t outerIterations = 0;
+    int64_t innerIterations = 0;
+
+    MeanPayoffSI(Game& g, int nthreads=0);
+
+    void solve();
+    const std::vector<Rational>& getValues()   const { return value; }
+    const std::vector<int32_t>&  getStrategy() const { return strategy; }
+};
+
+#endif // MPG_H
@@ -0,0 +1,69 @@
+/*
+ * Main authors:
+ *    Gonzalo Hernandez <gonzalo.hernandez@monash>
+ *    <gonzalo.hernandez@udenar.edu.co>
+ *
+ * Contributing authors:
+ *    Guido Tack <guido.tack@monash.edu>
+ *    Julian Gutierrez <J.Gutierrez@sussex.ac.uk>
+ *
+ * This file is part of NOCQ (a CP Toolchain for parity games with quantitative
+ * conditions).
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public License,
+ * v. 2.0. If a copy of the MPL was not distributed with this file, You can get
+ * one at https://mozilla.org/MPL/2.0/.
+ *
+ *-----------------------------------------------------------------------------
+ */
+#ifndef PARALLEL_H
+#define PARALLEL_H
+
+#include <thread>
+#include <vector>
+#include <algorithm>
+#include <cstdint>
+
+//-----------------------------------------------------------------------------
+// Number of worker threads to use when the caller asks for "as many as the
+// machine has" (nthreads <= 0).
+
+inline int resolveThreads(int nthreads) {
+    if (nthreads > 0) return nthreads;
+    int hw = static_cast<int>(std::thread::hardware_concurrency());
+    return hw > 0 ? hw : 1;
+}
+
+//-----------------------------------------------------------------------------
+// Split [begin,end) in one contiguous chunk per thread and call
+// body(chunk, lo, hi) on each of them. Ranges smaller than 'grain' run on the
+// calling thread only, so small sweeps do not pay for spawning threads.
+
+template <typename F>
+void parallelChunks(int64_t begin, int64_t end, int nthreads, F&& body,
+                    int64_t grain = 1 << 14)
+{
+    int64_t n = end - begin;
+    if (n <= 0) return;
+
+    int64_t chunks = std::min<int64_t>(resolveThreads(nthreads),
+                                       (n + grain - 1) / grain);
+    if (chunks <= 1) {
+        body(0, begin, end);
+        return;
+    }
+
+    std::vector<std::thread> workers;
+    workers.reserve(chunks-1);
+    int64_t size = (n + chunks - 1) / chunks;
+    for (int64_t c=1; c<chunks; c++) {
+        int64_t lo = begin + c*size;
+        int64_t hi = std::min(end, lo + size);
+        if (lo >= hi) break;
+        workers.emplace_back([&body, c, lo, hi]() { body(c, lo, hi); });
+    }
+    body(0, begin, std::min(end, begin + size));
+    for (auto& w : workers) w.join();
+}
+
+#endif // PARALLEL_H
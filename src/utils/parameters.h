@@ -44,7 +44,9 @@ struct options {
     std::string     exportFilename  = "";
     game_type       exportType      = DEF;      // DZN,GM,GMW,GAME,DIM
     std::string     method          = "";       // noc-even,noc-odd,sat
-                                                // zra,fra,scc
+                                                // zra,fpi,epm,epg,mpg-values
+                                                // mpg-search
+                                                // fra,scc
 
     std::string     solver          = "";       // chuffed-bool
                                                 // chuffed-int
@@ -55,7 +57,23 @@ struct options {
     bool            energyCond      = false;
     bool            meanpayoffCond  = false;
     int64_t         thresholdEnergy = 0;
+    int64_t         initialCredit   = -1;       // --credit (epm), -1: any
     double          thresholdMPG    = 0.0;
+    double          precisionMPG    = 0.0;      // --mpg-search precision
+    bool            parityScc       = false;    // parity by layered SCCs
+    bool            weightCycles    = false;    // energy/MP by negative cycles
+    bool            shortReasons    = false;    // minimal NOC explanations
+    bool            cycleNogoods    = false;    // keep bad cycles as nogoods
+    bool            sccMemo         = false;    // enumerate SCC entries once
+    bool            aliasEdges      = false;    // edges share source literals
+    amo_type        amo             = AMO_SEQ;  // one edge per PLAYER vertex
+    bool            pmModel         = false;    // parity by progress measures
+    int             mpBound         = 0;        // residual MPG bound period
+    bool            symmetry        = false;    // LDSB on interchangeable blocks
+    branch_type     branch          = BRANCH_SCAN; // PLAYER vertex order
+    bool            branchPriority  = false;    // good priorities first
+    warm_type       warmStart       = WARM_NONE; // first descent from a strategy
+    int             threads         = 0;        // 0=All hardware threads
 } options;
 
 //-----------------------------------------------------------------------------
@@ -73,7 +91,7 @@ bool parseMyOptions(int argc, char *argv[]) {
         return argv[i];
     };
     //-------------------------------------------------------------------------
-    auto parseInteger = [&](const char* str, int64_t min, int64_t max) -> int {
+    auto parseInteger = [&](const char* str, int64_t min, int64_t max) -> int64_t {
         char* endptr;
         errno = 0;
         int64_t val = std::strtoll(str, &endptr, 10);
@@ -158,11 +176,18 @@ bool parseMyOptions(int argc, char *argv[]) {
         << "  --init <vertex>            : Initial vertex (Default=0)\n"
         << "  --max | --min              : Optimization goal (Default: --max)\n"
         << "  --weights <w1> <w2>        : Weights range\n"
+        << "  --threads <n>              : Worker threads (Default: all cores)\n"
         // << "  --flip                     : Complement the game\n"
         << "\n"
         << "Methods:\n"
         << "  --noc-even | --noc-odd     : NOC player preference (Default: --noc-even)\n"
         << "  --fra                      : Solve using FRA algorithm\n"
+        << "  --zra                      : Solve using Zielonka's algorithm\n"
+        << "  --fpi                      : Solve using parallel fixpoint iteration\n"
+        << "  --epm                      : Solve energy/mean-payoff using progress measures\n"
+        << "  --mpg-values               : Exact mean-payoff values (policy iteration)\n"
+        << "  --epg                      : Solve energy parity games (recursive)\n"
+        << "  --mpg-search <precision>   : Best mean-payoff threshold (NOC bisection)\n"
         << "  --scc                      : Compute Strongly Connected Components\n"
         << "  --sat-encoding <filename>  : Encode on DIMACS file\n"
         << "\n"
@@ -171,11 +196,42 @@ bool parseMyOptions(int argc, char *argv[]) {
         << "  --chuffed-int              : Use Chuffed with IntVars\n"
         << "  --gecode                   : Use Gecode solver (BoolVars)\n"
         << "  --cadical                  : Use Cadical solver\n"
+        << "  --short-reasons            : Explain NOC conflicts by the cycle and\n"
+        << "                               a shortest path from init\n"
+        << "  --cycle-nogoods            : Keep every bad cycle found as a nogood\n"
+        << "  --scc-memo                 : Enumerate NOC paths from a component\n"
+        << "                               entry once per propagation\n"
+        << "  --alias-edges              : Opponent and single edges reuse the\n"
+        << "                               literal of their source (chuffed-bool)\n"
+        << "  --amo <seq|product|native> : At most one edge per player vertex by a\n"
+        << "                               sequential counter (Default), product\n"
+        << "                               encoding or propagator\n"
+        << "  --pm-model                 : Parity by progress-measure ranks in the\n"
+        << "                               model (chuffed-bool)\n"
+        << "  --mp-bound <period>        : Fail mean-payoff nodes whose residual\n"
+        << "                               game EVEN loses, every period-th check\n"
+        << "                               (chuffed-bool)\n"
+        << "  --symmetry                 : Break symmetries between interchangeable\n"
+        << "                               blocks with LDSB (chuffed-int)\n"
+        << "  --branch <strategy>        : Player vertices to branch on: scan\n"
+        << "                               (Default), or the reached ones by dfs\n"
+        << "                               or activity (chuffed-bool)\n"
+        << "  --branch-priority          : Try edges towards good priorities first\n"
+        << "                               (chuffed-bool)\n"
+        << "  --warm-start <engine>      : Try first the strategy of zielonka or mpg\n"
+        << "                               (chuffed-bool and chuffed-int)\n"
+        << "  --nsolutions <n>           : Enumerate up to n player strategies, 0 for\n"
+        << "                               all (chuffed-bool and chuffed-int)\n"
         << "\n"
         << "Conditions:\n"
         << "  --parity                   : Parity condition (default)\n"
+        << "  --parity-scc               : Check parity cycles by layered SCCs\n"
         << "  --energy [thresh]          : Energy condition (default Threshold=0)\n"
         << "  --mean-payoff [thresh]     : Mean-Payoff condition (default Threshold=0.0)\n"
+        << "  --credit <c>               : EVEN's initial credit for --epm (default: any\n"
+        << "                               finite credit)\n"
+        << "  --weight-cycles            : Check energy (thresh 0) and mean-payoff\n"
+        << "                               cycles by negative-cycle detection\n"
         << "\n"
         << "Output & Export:\n"
         << "  --print-time               : Print result + solving time\n"
@@ -293,9 +349,18 @@ bool parseMyOptions(int argc, char *argv[]) {
             options.exportType = DIM;
             options.exportFilename = argv[i];
         }
+        else if (strcmp(argv[i],"--threads")==0) {
+            validateArg("--threads <number>");
+            options.threads = parseInteger(argv[i], 1, 4096);
+        }
+        else if (strcmp(argv[i],"--mpg-search")==0) {
+            validateArg("--mpg-search <precision>");
+            options.method = "mpg-search";
+            options.precisionMPG = parseDouble(argv[i], 1e-9, 1e15);
+        }
         else if (strcmp(argv[i],"--nsolutions")==0) {
             validateArg("--nsolutions <number>");
-            so.nof_solutions = parseInteger(argv[i], 0, 10);
+            so.nof_solutions = parseInteger(argv[i], 0, 1000000000);
         }
         else if (strcmp(argv[i],"--energy")==0) {
             i++; // Move to the next argument
@@ -307,6 +372,10 @@ bool parseMyOptions(int argc, char *argv[]) {
             }
             options.energyCond = true;
         }
+        else if (strcmp(argv[i],"--credit")==0) {
+            validateArg("--credit <credit>");
+            options.initialCredit = parseInteger(argv[i], 0, LLONG_MAX);
+        }
         else if (strcmp(argv[i],"--mean-payoff")==0) {
             i++; // Move to the next argument
             if (i>=argc || (strlen(argv[i])>1 && strncmp(argv[i],"--",2) == 0)) {
@@ -332,6 +401,14 @@ bool parseMyOptions(int argc, char *argv[]) {
                                 { options.method            = "noc-odd"; }
         else if (strcmp(argv[i],"--zra")==0)
                                 { options.method            = "zra"; }
+        else if (strcmp(argv[i],"--fpi")==0)
+                                { options.method            = "fpi"; }
+        else if (strcmp(argv[i],"--epm")==0)
+                                { options.method            = "epm"; }
+        else if (strcmp(argv[i],"--mpg-values")==0)
+                                { options.method            = "mpg-values"; }
+        else if (strcmp(argv[i],"--epg")==0)
+                                { options.method            = "epg"; }
         else if (strcmp(argv[i],"--fra")==0)
                                 { options.method            = "fra"; }
         else if (strcmp(argv[i],"--scc")==0)
@@ -366,6 +443,58 @@ bool parseMyOptions(int argc, char *argv[]) {
                                 { options.flip              = true;}
         else if (strcmp(argv[i],"--parity")==0)
                                 { options.parityCond       = true; }
+        else if (strcmp(argv[i],"--parity-scc")==0)
+                                { options.parityCond       = true;
+                                  options.parityScc        = true; }
+        else if (strcmp(argv[i],"--weight-cycles")==0)
+                                { options.weightCycles     = true; }
+        else if (strcmp(argv[i],"--short-reasons")==0)
+                                { options.shortReasons     = true; }
+        else if (strcmp(argv[i],"--cycle-nogoods")==0)
+                                { options.cycleNogoods     = true; }
+        else if (strcmp(argv[i],"--scc-memo")==0)
+                                { options.sccMemo          = true; }
+        else if (strcmp(argv[i],"--alias-edges")==0)
+                                { options.aliasEdges       = true; }
+        else if (strcmp(argv[i],"--pm-model")==0)
+                                { options.pmModel          = true; }
+        else if (strcmp(argv[i],"--symmetry")==0)
+                                { options.symmetry         = true; }
+        else if (strcmp(argv[i],"--branch-priority")==0)
+                                { options.branchPriority   = true; }
+        else if (strcmp(argv[i],"--mp-bound")==0) {
+            validateArg("--mp-bound <period>");
+            options.mpBound = parseInteger(argv[i], 1, 1000000);
+        }
+        else if (strcmp(argv[i],"--branch")==0) {
+            validateArg("--branch <scan|dfs|activity>");
+            if      (strcmp(argv[i],"scan")==0)     options.branch = BRANCH_SCAN;
+            else if (strcmp(argv[i],"dfs")==0)      options.branch = BRANCH_DFS;
+            else if (strcmp(argv[i],"activity")==0) options.branch = BRANCH_ACTIVITY;
+            else {
+                std::cerr << "ERROR: Invalid value for [--branch]\n";
+                exit(1);
+            }
+        }
+        else if (strcmp(argv[i],"--warm-start")==0) {
+            validateArg("--warm-start <zielonka|mpg>");
+            if      (strcmp(argv[i],"zielonka")==0) options.warmStart = WARM_ZIELONKA;
+            else if (strcmp(argv[i],"mpg")==0)      options.warmStart = WARM_MPG;
+            else {
+                std::cerr << "ERROR: Invalid value for [--warm-start]\n";
+                exit(1);
+            }
+        }
+        else if (strcmp(argv[i],"--amo")==0) {
+            validateArg("--amo <seq|product|native>");
+            if      (strcmp(argv[i],"seq")==0)     options.amo = AMO_SEQ;
+            else if (strcmp(argv[i],"product")==0) options.amo = AMO_PRODUCT;
+            else if (strcmp(argv[i],"native")==0)  options.amo = AMO_NATIVE;
+            else {
+                std::cerr << "ERROR: Invalid value for [--amo]\n";
+                exit(1);
+            }
+        }
 
         else if (strcmp(argv[i],"--help")==0) {
             showHelp();
@@ -20,7 +20,7 @@
 #include "zielonka.h"
 #include "array"
 
-Zielonka::Zielonka(Game& g) : g(g) {
+Zielonka::Zielonka(Game& g) : g(g), strategy(g.nvertices,-1) {
 }
 
 //-----------------------------------------------------------------------------
@@ -74,6 +74,7 @@ void Zielonka::attractor(int player, std::vector<int>&U, bool* removed) {
                 if (ally) {
                     U.push_back(v);
                     d[v] = 1;
+                    strategy[v] = e;
                 }
                 else {
                     int outbound = 0ull;
@@ -106,10 +107,20 @@ std::array<std::vector<int>,2> Zielonka::search(bool* removed, int level) {
     int player = g.priors[A[0]] % 2;
     std::unique_ptr<bool[]> removed1 = std::make_unique<bool[]>(g.nvertices);
     std::copy_n(removed, g.nvertices, removed1.get());
+    size_t nbest = A.size();
 
     attractor(player, A, removed1.get());
     auto win1 = search(removed1.get(),level+1); 
     if (!win1[1-player].size()) {
+        // The best vertices of the player only have to stay in the game.
+        for (size_t k=0; k<nbest; k++) {
+            int v = A[k];
+            if (g.owners[v] != player) continue;
+            for (size_t j=0; j<g.outs[v].size(); j++) {
+                int e = g.outs[v][j];
+                if (!removed[g.targets[e]]) { strategy[v] = e; break; }
+            }
+        }
         win1[player].reserve(win1[player].size() + A.size());
         win1[player].insert(win1[player].end(), A.begin(), A.end());
         return win1;
@@ -130,6 +141,7 @@ std::array<std::vector<int>,2> Zielonka::search(bool* removed, int level) {
 //-----------------------------------------------------------------------------
 
 std::array<std::vector<int>,2> Zielonka::solve() {
+    std::fill(strategy.begin(), strategy.end(), -1);
     std::unique_ptr<bool[]> removed = std::make_unique<bool[]>(g.nvertices);
     std::fill_n(removed.get(), g.nvertices, false);
     return search(removed.get());
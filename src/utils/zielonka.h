@@ -30,6 +30,8 @@ class Zielonka {
 private:
     Game& g;
 public:
+    std::vector<int> strategy;  // edge kept by the winner of each vertex, or -1
+
     Zielonka(Game& g);
 
     std::vector<int> getBestVertices(bool* removed);